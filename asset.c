@@ -0,0 +1,337 @@
+// Copyright (c) 2026 embeddedboys developers
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include <stdio.h>
+#include <string.h>
+
+#include "pico/time.h"
+
+#include "lvgl/lvgl.h"
+
+#include "asset.h"
+
+#define DRV_NAME "asset"
+
+#define pr_debug   printf
+#define __ram_func __attribute__((section(".time_critical." DRV_NAME)))
+
+#if ASSET_PACK_ENABLED
+
+typedef unsigned int u32;
+typedef unsigned short u16;
+typedef unsigned char u8;
+
+/* decoded glyphs, direct mapped by font and glyph id */
+struct glyph_slot {
+	const lv_font_t *font;
+	u32 gid;
+	u8 bitmap[ASSET_GLYPH_MAX];
+};
+
+static struct glyph_slot glyph_cache[ASSET_GLYPH_CACHE_SLOTS];
+static u32 glyph_hit, glyph_miss;
+
+struct glyph_out {
+	u8 *dst;
+	u8 prev[256]; /* the row above, box_w is 8-bit */
+	u32 i;
+	u32 col;
+	u32 w;
+	u8 bpp;
+};
+
+static inline void glyph_put(struct glyph_out *o, u8 v)
+{
+	u32 bit = o->i++ * o->bpp;
+
+	v ^= o->prev[o->col];
+	o->prev[o->col] = v;
+	if (++o->col == o->w)
+		o->col = 0;
+
+	o->dst[bit >> 3] |= v << (8 - o->bpp - (bit & 7));
+}
+
+/* into LVGL's plain bitmap_format 0 layout */
+static void __ram_func asset_glyph_decode(const u8 *src, u8 *dst, u32 w,
+					  u32 count, u8 bpp)
+{
+	struct glyph_out o;
+	u32 n, k;
+	u8 t, v;
+
+	o.dst = dst;
+	o.i = 0;
+	o.col = 0;
+	o.w = w;
+	o.bpp = bpp;
+	memset(o.prev, 0, w);
+	memset(dst, 0, (count * bpp + 7) / 8);
+
+	while (o.i < count) {
+		t = *src++;
+
+		if (t & 0x80) {
+			n = (t >> 4) & 7;
+			n = n == 7 ? *src++ + 10 : n + 3;
+			v = t & 0xf;
+			for (k = 0; k < n && o.i < count; k++)
+				glyph_put(&o, v);
+		} else {
+			n = t + 1;
+			for (k = 0; k < n && o.i < count; k++)
+				glyph_put(&o, k & 1 ? src[k / 2] & 0xf :
+						      src[k / 2] >> 4);
+			src += (n + 1) / 2;
+		}
+	}
+}
+
+static const u8 *__ram_func asset_glyph_get(const lv_font_t *font, u32 gid)
+{
+	const lv_font_fmt_txt_dsc_t *fdsc = font->dsc;
+	const lv_font_fmt_txt_glyph_dsc_t *gdsc = &fdsc->glyph_dsc[gid];
+	u32 count = gdsc->box_w * gdsc->box_h;
+	struct glyph_slot *slot;
+
+	if ((count * fdsc->bpp + 7) / 8 > ASSET_GLYPH_MAX)
+		return NULL;
+
+	slot = &glyph_cache[(gid + ((uintptr_t)font >> 4)) %
+			    ASSET_GLYPH_CACHE_SLOTS];
+	if (slot->font == font && slot->gid == gid) {
+		glyph_hit++;
+		return slot->bitmap;
+	}
+
+	glyph_miss++;
+	asset_glyph_decode(&fdsc->glyph_bitmap[gdsc->bitmap_index],
+			   slot->bitmap, gdsc->box_w, count, fdsc->bpp);
+	slot->font = font;
+	slot->gid = gid;
+
+	return slot->bitmap;
+}
+
+/* get_glyph_bitmap of the generated fonts */
+const uint8_t *__ram_func asset_font_get_bitmap(const lv_font_t *font,
+						uint32_t letter)
+{
+	const lv_font_fmt_txt_dsc_t *fdsc = font->dsc;
+	lv_font_glyph_dsc_t g;
+
+	/*
+	 * lv_draw_letter() has just looked up the descriptor of this letter,
+	 * the glyph id is still in the font cache. Look it up otherwise.
+	 */
+	if (fdsc->cache->last_letter != letter)
+		lv_font_get_glyph_dsc_fmt_txt(font, &g, letter, 0);
+
+	if (fdsc->cache->last_letter != letter || !fdsc->cache->last_glyph_id)
+		return NULL;
+
+	return asset_glyph_get(font, fdsc->cache->last_glyph_id);
+}
+
+static bool asset_img_is_ours(const void *src)
+{
+	const lv_img_dsc_t *img = src;
+
+	return lv_img_src_get_type(src) == LV_IMG_SRC_VARIABLE &&
+	       img->header.cf == ASSET_IMG_CF;
+}
+
+static lv_res_t asset_img_info(lv_img_decoder_t *decoder, const void *src,
+			       lv_img_header_t *header)
+{
+	const lv_img_dsc_t *img = src;
+
+	if (!asset_img_is_ours(src))
+		return LV_RES_INV;
+
+	header->w = img->header.w;
+	header->h = img->header.h;
+	header->cf = LV_IMG_CF_TRUE_COLOR;
+	header->always_zero = 0;
+
+	return LV_RES_OK;
+}
+
+/* no full-frame buffer, lines are decoded on request */
+static lv_res_t asset_img_open(lv_img_decoder_t *decoder,
+			       lv_img_decoder_dsc_t *dsc)
+{
+	if (!asset_img_is_ours(dsc->src))
+		return LV_RES_INV;
+
+	dsc->img_data = NULL;
+	return LV_RES_OK;
+}
+
+static lv_res_t __ram_func asset_img_read_line(lv_img_decoder_t *decoder,
+					       lv_img_decoder_dsc_t *dsc,
+					       lv_coord_t x, lv_coord_t y,
+					       lv_coord_t len, uint8_t *buf)
+{
+	const lv_img_dsc_t *img = dsc->src;
+	const struct asset_img *a = (const struct asset_img *)img->data;
+	const u8 *p = &a->runs[a->line_ofs[y]];
+	lv_color_t *out = (lv_color_t *)buf;
+	lv_coord_t pos = 0, n;
+	u16 c;
+
+	/* skip the runs left of x */
+	while (pos + p[0] + 1 <= x) {
+		pos += p[0] + 1;
+		p += 2;
+	}
+	n = pos + p[0] + 1 - x;
+
+	for (;;) {
+		c = a->pal[p[1]];
+#if LV_COLOR_DEPTH == 8
+		/* RGB332 for the indexed draw buffer */
+		c = (c >> 8 & 0xe0) | (c >> 6 & 0x1c) | (c >> 3 & 0x03);
+#endif
+		if (n > len)
+			n = len;
+		len -= n;
+		while (n--)
+			(out++)->full = c;
+
+		if (!len)
+			break;
+
+		p += 2;
+		n = p[0] + 1;
+	}
+
+	return LV_RES_OK;
+}
+
+static void asset_img_close(lv_img_decoder_t *decoder,
+			    lv_img_decoder_dsc_t *dsc)
+{
+}
+
+/* Call after lv_init() */
+void asset_init(void)
+{
+	lv_img_decoder_t *dec;
+	int i;
+
+	for (i = 0; asset_fonts[i]; i++) {
+		const struct asset_font *af = asset_fonts[i]->user_data;
+
+		if (af->max_glyph > ASSET_GLYPH_MAX)
+			pr_debug("%s: %s has glyphs of %d bytes, over ASSET_GLYPH_MAX\n",
+				 DRV_NAME, asset_font_names[i], af->max_glyph);
+	}
+
+	dec = lv_img_decoder_create();
+	lv_img_decoder_set_info_cb(dec, asset_img_info);
+	lv_img_decoder_set_open_cb(dec, asset_img_open);
+	lv_img_decoder_set_read_line_cb(dec, asset_img_read_line);
+	lv_img_decoder_set_close_cb(dec, asset_img_close);
+}
+
+#define ASSET_BENCH_LOOPS 20
+
+/*
+ * Flash saved against the render time it costs: a full decode of every
+ * glyph and image, and the lookup of a cached glyph.
+ */
+void asset_benchmark(void)
+{
+	static u8 scratch[ASSET_GLYPH_MAX];
+	lv_img_decoder_dsc_t dsc;
+	u32 t, gid, loop, y, n;
+	uint8_t *line;
+	int i;
+
+	pr_debug("%s: benchmark\n", DRV_NAME);
+
+	for (i = 0; asset_fonts[i]; i++) {
+		const lv_font_t *font = asset_fonts[i];
+		const lv_font_fmt_txt_dsc_t *fdsc = font->dsc;
+		const struct asset_font *af = font->user_data;
+		const lv_font_fmt_txt_glyph_dsc_t *gdsc;
+
+		t = time_us_32();
+		for (loop = 0, n = 0; loop < ASSET_BENCH_LOOPS; loop++) {
+			for (gid = 1; gid < af->glyph_cnt; gid++) {
+				gdsc = &fdsc->glyph_dsc[gid];
+				if (gdsc->box_w * gdsc->box_h * fdsc->bpp >
+				    ASSET_GLYPH_MAX * 8)
+					continue;
+				asset_glyph_decode(
+					&fdsc->glyph_bitmap[gdsc->bitmap_index],
+					scratch, gdsc->box_w,
+					gdsc->box_w * gdsc->box_h, fdsc->bpp);
+				n++;
+			}
+		}
+		t = time_us_32() - t;
+
+		pr_debug("%s: %-16s %6u -> %6u bytes, %3u%% saved, decode %u ns/glyph\n",
+			 DRV_NAME, asset_font_names[i], af->raw_size,
+			 af->packed_size,
+			 100 - af->packed_size * 100 / af->raw_size,
+			 n ? t * 1000 / n : 0);
+
+		asset_glyph_get(font, 1);
+		t = time_us_32();
+		for (loop = 0; loop < 1000; loop++)
+			asset_glyph_get(font, 1);
+		t = time_us_32() - t;
+
+		pr_debug("%s: %-16s cached glyph %u ns\n", DRV_NAME,
+			 asset_font_names[i], t);
+	}
+
+	for (i = 0; asset_images[i]; i++) {
+		const lv_img_dsc_t *img = asset_images[i];
+		const struct asset_img *a = (const struct asset_img *)img->data;
+
+		line = lv_mem_buf_get(img->header.w * sizeof(lv_color_t));
+		dsc.src = img;
+
+		t = time_us_32();
+		for (loop = 0; loop < ASSET_BENCH_LOOPS; loop++)
+			for (y = 0; y < img->header.h; y++)
+				asset_img_read_line(NULL, &dsc, 0, y,
+						    img->header.w, line);
+		t = (time_us_32() - t) / ASSET_BENCH_LOOPS;
+
+		lv_mem_buf_release(line);
+
+		pr_debug("%s: %-16s %6u -> %6u bytes, %3u%% saved, decode %u us/frame\n",
+			 DRV_NAME, asset_image_names[i], a->raw_size,
+			 a->packed_size, 100 - a->packed_size * 100 / a->raw_size,
+			 t);
+	}
+
+	pr_debug("%s: glyph cache %u hits, %u misses\n", DRV_NAME, glyph_hit,
+		 glyph_miss);
+}
+
+#endif
@@ -0,0 +1,89 @@
+# Copyright (c) 2024 embeddedboys developers
+
+# Permission is hereby granted, free of charge, to any person obtaining
+# a copy of this software and associated documentation files (the
+# "Software"), to deal in the Software without restriction, including
+# without limitation the rights to use, copy, modify, merge, publish,
+# distribute, sublicense, and/or sell copies of the Software, and to
+# permit persons to whom the Software is furnished to do so, subject to
+# the following conditions:
+
+# The above copyright notice and this permission notice shall be
+# included in all copies or substantial portions of the Software.
+
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+# MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+# NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+# LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+# OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+# WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+# Compressed asset pipeline
+#
+# The fonts and images listed below are converted by tools/asset_pack.py at
+# build time and linked into the target. Fonts are the C files written by
+# lv_font_conv and come out as <name>_rle, images as img_<name>. The
+# generated asset_list.h declares them all, asset.c decodes them.
+
+find_package(Python3 COMPONENTS Interpreter)
+if(NOT Python3_Interpreter_FOUND)
+    message(FATAL_ERROR "ERROR: ASSET_PACK_ENABLED needs python3 to run tools/asset_pack.py")
+endif()
+
+set(ASSET_PACK_DIR ${CMAKE_CURRENT_LIST_DIR})
+
+set(ASSET_FONTS
+    ${CMAKE_CURRENT_LIST_DIR}/factory/font/fsex_16.c
+    ${CMAKE_CURRENT_LIST_DIR}/factory/font/fsex_20.c
+)
+
+# .ppm, or any format Pillow reads when it is installed
+set(ASSET_IMAGES
+)
+
+function(asset_pack_setup TARGET)
+    set(TOOL ${ASSET_PACK_DIR}/tools/asset_pack.py)
+    set(OUT_DIR ${CMAKE_BINARY_DIR}/assets)
+    file(MAKE_DIRECTORY ${OUT_DIR})
+
+    set(SOURCES)
+    set(FONTS)
+    set(IMAGES)
+
+    foreach(SRC ${ASSET_FONTS})
+        get_filename_component(NAME ${SRC} NAME_WE)
+        set(NAME ${NAME}_rle)
+        add_custom_command(OUTPUT ${OUT_DIR}/${NAME}.c
+            COMMAND ${Python3_EXECUTABLE} ${TOOL} font ${SRC} ${OUT_DIR}/${NAME}.c ${NAME}
+            DEPENDS ${SRC} ${TOOL}
+            COMMENT "Packing font ${NAME}"
+            VERBATIM)
+        list(APPEND SOURCES ${OUT_DIR}/${NAME}.c)
+        list(APPEND FONTS ${NAME})
+    endforeach()
+
+    foreach(SRC ${ASSET_IMAGES})
+        get_filename_component(NAME ${SRC} NAME_WE)
+        set(NAME img_${NAME})
+        add_custom_command(OUTPUT ${OUT_DIR}/${NAME}.c
+            COMMAND ${Python3_EXECUTABLE} ${TOOL} image ${SRC} ${OUT_DIR}/${NAME}.c ${NAME}
+            DEPENDS ${SRC} ${TOOL}
+            COMMENT "Packing image ${NAME}"
+            VERBATIM)
+        list(APPEND SOURCES ${OUT_DIR}/${NAME}.c)
+        list(APPEND IMAGES ${NAME})
+    endforeach()
+
+    add_custom_command(OUTPUT ${OUT_DIR}/asset_list.c ${OUT_DIR}/asset_list.h
+        COMMAND ${Python3_EXECUTABLE} ${TOOL} index
+                ${OUT_DIR}/asset_list.c ${OUT_DIR}/asset_list.h
+                --fonts ${FONTS} --images ${IMAGES}
+        DEPENDS ${TOOL} ${ASSET_PACK_DIR}/asset_pack.cmake
+        COMMENT "Generating asset list"
+        VERBATIM)
+    list(APPEND SOURCES ${OUT_DIR}/asset_list.c)
+
+    target_sources(${TARGET} PRIVATE ${SOURCES})
+    target_include_directories(${TARGET} PRIVATE ${OUT_DIR})
+endfunction()
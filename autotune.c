@@ -0,0 +1,450 @@
+// Copyright (c) 2026 embeddedboys developers
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#define pr_fmt(fmt) "autotune: " fmt
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+#include "pico/multicore.h"
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+#include "hardware/vreg.h"
+#include "hardware/uart.h"
+#include "hardware/clocks.h"
+#include "hardware/watchdog.h"
+#include "hardware/structs/watchdog.h"
+#if PICO_RP2040
+#include "hardware/structs/ssi.h"
+#else
+#include "hardware/structs/qmi.h"
+#endif
+
+#include "ft6236.h"
+#include "backlight.h"
+#include "autotune.h"
+
+#define pr_debug printf
+
+#define ARRAY_SIZE(arr) (sizeof(arr) / sizeof(arr[0]))
+
+extern void i80_set_bus_clk_khz(uint32_t khz);
+extern uint32_t i80_get_bus_clk_max_khz(void);
+
+/* "w25q16" and friends, see the note about PICO_FLASH_SPI_CLKDIV */
+#define FLASH_MAX_KHZ 133000
+
+#define AUTOTUNE_MAGIC	  0x41544e31 /* ATN1 */
+#define AUTOTUNE_WDT_MS	  1000
+#define AUTOTUNE_ROUNDS	  8
+#define AUTOTUNE_PATTERN  1024 /* words */
+#define AUTOTUNE_XIP_SIZE (16 * 1024)
+
+/* the profile lives in the last sector of the flash */
+#define PROFILE_FLASH_OFFS (PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE)
+
+/*
+ * Watchdog scratch registers survive the reboot when a candidate hangs the
+ * chip, that is how the tuner knows which one failed. 4-7 belong to the SDK.
+ */
+#define SCRATCH_MAGIC 0
+#define SCRATCH_STATE 1 /* stage << 16 | index under test */
+#define SCRATCH_BEST  2 /* best sys index << 16 | best bus index */
+#define IDX_NONE      0xffff
+
+enum { STAGE_SYS, STAGE_BUS, STAGE_DONE };
+
+/* same steps as the overclocking profiles in CMakeLists.txt */
+static const uint32_t sys_khz_steps[] = {
+#if PICO_RP2040
+	240000, 266000, 360000, 400000, 416000,
+#else
+	366000, 384000,
+#endif
+};
+
+static const uint32_t bus_khz_steps[] = {
+	50000, 54000, 58000, 62000, 66000, 70000,
+};
+
+struct profile_record {
+	uint32_t magic;
+	struct clock_profile prof;
+	uint32_t sum;
+};
+
+static autotune_check_t bus_check;
+static uint32_t xip_ref_sum;
+
+static const struct clock_profile default_profile = {
+	.sys_khz = DEFAULT_SYS_CLK_KHZ,
+	.bus_khz = I80_BUS_WR_CLK_KHZ,
+	.flash_div = DEFAULT_FLASH_SPI_CLKDIV,
+};
+
+static uint32_t autotune_sum(const volatile uint32_t *p, size_t words)
+{
+	uint32_t sum = 0x811c9dc5;
+
+	while (words--)
+		sum = (sum ^ *p++) * 0x01000193;
+
+	return sum;
+}
+
+/* smallest divider that keeps the XIP flash within spec */
+uint32_t clock_profile_flash_div(uint32_t sys_khz)
+{
+	uint32_t div = (sys_khz + FLASH_MAX_KHZ - 1) / FLASH_MAX_KHZ;
+
+	if (div < 2)
+		div = 2;
+#if PICO_RP2040
+	/* SSI baudr must be even */
+	div = (div + 1) & ~1u;
+#endif
+	return div;
+}
+
+/* the divider of the applied profile, 0: still the one boot2 set */
+static uint32_t flash_div_cur;
+
+/* XIP is stopped while the divider changes, so this must run from SRAM */
+static void __no_inline_not_in_flash_func(flash_write_clkdiv)(uint32_t div)
+{
+	uint32_t irq = save_and_disable_interrupts();
+
+#if PICO_RP2040
+	ssi_hw->ssienr = 0;
+	ssi_hw->baudr = div;
+	ssi_hw->ssienr = 1;
+#else
+	hw_write_masked(&qmi_hw->m[0].timing, div << QMI_M0_TIMING_CLKDIV_LSB,
+			QMI_M0_TIMING_CLKDIV_BITS);
+#endif
+
+	restore_interrupts(irq);
+}
+
+/*
+ * The other core must not fetch from XIP either, it is parked in SRAM like
+ * flash_safe_execute() does, e.g. core1 running LVGL with LVGL_USE_CORE1.
+ */
+static void flash_set_clkdiv(uint32_t div)
+{
+	bool lockout = multicore_lockout_victim_is_initialized(get_core_num() ^ 1);
+
+	if (lockout)
+		multicore_lockout_start_blocking();
+	flash_write_clkdiv(div);
+	if (lockout)
+		multicore_lockout_end_blocking();
+
+	flash_div_cur = div;
+}
+
+/*
+ * flash_range_erase() and flash_range_program() go back to XIP through
+ * boot2, which sets the build time PICO_FLASH_SPI_CLKDIV again. Anything
+ * writing the flash calls this after flash_safe_execute(), or the flash
+ * may run out of spec until the next profile switch.
+ */
+void clock_profile_flash_restore(void)
+{
+	if (flash_div_cur)
+		flash_set_clkdiv(flash_div_cur);
+}
+
+static enum vreg_voltage vreg_for(uint32_t sys_khz)
+{
+	uint32_t mhz = sys_khz / 1000;
+
+	/* NOTE: DO NOT MODIFY THIS BLOCK */
+	if (mhz > 266 && mhz <= 360)
+		return VREG_VOLTAGE_1_20;
+	else if (mhz > 360 && mhz <= 396)
+		return VREG_VOLTAGE_1_25;
+	else if (mhz > 396)
+		return VREG_VOLTAGE_MAX;
+	else
+		return VREG_VOLTAGE_DEFAULT;
+}
+
+/*
+ * Going up, the flash divider and the core voltage are raised before the
+ * clock. Going down, the clock drops first.
+ */
+void clock_profile_apply(const struct clock_profile *prof)
+{
+	uint32_t mhz = prof->sys_khz / 1000;
+	bool faster = prof->sys_khz * 1000ull > clock_get_hz(clk_sys);
+
+	if (faster) {
+		flash_set_clkdiv(prof->flash_div);
+		vreg_set_voltage(vreg_for(prof->sys_khz));
+		busy_wait_us(10);
+	}
+
+	set_sys_clock_khz(mhz * 1000, true);
+	clock_configure(clk_peri, 0, CLOCKS_CLK_PERI_CTRL_AUXSRC_VALUE_CLK_SYS,
+			mhz * MHZ, mhz * MHZ);
+
+	if (!faster) {
+		vreg_set_voltage(vreg_for(prof->sys_khz));
+		flash_set_clkdiv(prof->flash_div);
+	}
+
+	i80_set_bus_clk_khz(prof->bus_khz);
+}
+
+/* at runtime, peripheral dividers derived from clk_sys/clk_peri follow */
+void clock_profile_switch(const struct clock_profile *prof)
+{
+	uart_tx_wait_blocking(uart0);
+	clock_profile_apply(prof);
+	uart_set_baudrate(uart0, 115200);
+	ft6236_update_clk();
+	backlight_update_clk();
+}
+
+static bool profile_record_valid(const struct profile_record *rec)
+{
+	return rec->magic == AUTOTUNE_MAGIC &&
+	       rec->sum == autotune_sum((const uint32_t *)&rec->prof,
+					sizeof(rec->prof) / 4);
+}
+
+static void profile_from_best(struct clock_profile *prof, uint32_t best)
+{
+	uint32_t sys_idx = best >> 16;
+	uint32_t bus_idx = best & 0xffff;
+
+	*prof = default_profile;
+
+	if (sys_idx != IDX_NONE) {
+		prof->sys_khz = sys_khz_steps[sys_idx];
+		prof->flash_div = clock_profile_flash_div(prof->sys_khz);
+	}
+
+	if (bus_idx != IDX_NONE)
+		prof->bus_khz = bus_khz_steps[bus_idx];
+
+	/* store what the bus really runs at, the controller may be slower */
+	if (i80_get_bus_clk_max_khz() && prof->bus_khz > i80_get_bus_clk_max_khz())
+		prof->bus_khz = i80_get_bus_clk_max_khz();
+}
+
+static bool autotune_resuming(void)
+{
+	return watchdog_caused_reboot() &&
+	       watchdog_hw->scratch[SCRATCH_MAGIC] == AUTOTUNE_MAGIC;
+}
+
+/*
+ * Stored profile if there is a valid one, the best one found so far when
+ * coming back from a candidate that hung, the CMake values otherwise.
+ */
+void clock_profile_load(struct clock_profile *prof)
+{
+	const struct profile_record *rec =
+		(const struct profile_record *)(XIP_BASE + PROFILE_FLASH_OFFS);
+
+	if (autotune_resuming()) {
+		profile_from_best(prof, watchdog_hw->scratch[SCRATCH_BEST]);
+		return;
+	}
+
+	watchdog_hw->scratch[SCRATCH_MAGIC] = 0;
+
+	if (profile_record_valid(rec))
+		*prof = rec->prof;
+	else
+		*prof = default_profile;
+}
+
+static void profile_store_cb(void *param)
+{
+	flash_range_erase(PROFILE_FLASH_OFFS, FLASH_SECTOR_SIZE);
+	flash_range_program(PROFILE_FLASH_OFFS, param, FLASH_PAGE_SIZE);
+}
+
+static int profile_store(const struct clock_profile *prof)
+{
+	static uint8_t page[FLASH_PAGE_SIZE];
+	struct profile_record *rec = (struct profile_record *)page;
+	int ret;
+
+	memset(page, 0xff, sizeof(page));
+	rec->magic = AUTOTUNE_MAGIC;
+	rec->prof = *prof;
+	rec->sum = autotune_sum((const uint32_t *)&rec->prof,
+				sizeof(rec->prof) / 4);
+
+	ret = flash_safe_execute(profile_store_cb, page, UINT32_MAX);
+	clock_profile_flash_restore();
+	return ret;
+}
+
+/*
+ * Write-then-verify a pseudo random pattern in SRAM and compare an uncached
+ * read of the start of the flash with the one taken at safe clocks.
+ */
+static bool autotune_check_core(void)
+{
+	uint32_t *buf = malloc(AUTOTUNE_PATTERN * sizeof(uint32_t));
+	uint32_t seed, x;
+	bool ok = true;
+	int r, i;
+
+	if (!buf)
+		return false;
+
+	for (r = 0; r < AUTOTUNE_ROUNDS && ok; r++) {
+		seed = 0x9e3779b9 * (r + 1);
+
+		for (i = 0, x = seed; i < AUTOTUNE_PATTERN; i++) {
+			x ^= x << 13, x ^= x >> 17, x ^= x << 5;
+			buf[i] = x;
+		}
+
+		for (i = 0, x = seed; i < AUTOTUNE_PATTERN; i++) {
+			x ^= x << 13, x ^= x >> 17, x ^= x << 5;
+			if (buf[i] != x) {
+				ok = false;
+				break;
+			}
+		}
+
+		if (autotune_sum((const uint32_t *)XIP_NOCACHE_NOALLOC_BASE,
+				 AUTOTUNE_XIP_SIZE / 4) != xip_ref_sum)
+			ok = false;
+	}
+
+	free(buf);
+	return ok;
+}
+
+static bool autotune_try(const struct clock_profile *prof, uint32_t stage,
+			 uint32_t idx)
+{
+	bool ok;
+
+	watchdog_hw->scratch[SCRATCH_STATE] = stage << 16 | idx;
+	watchdog_update();
+
+	clock_profile_switch(prof);
+	ok = autotune_check_core();
+	if (ok && stage == STAGE_BUS)
+		ok = bus_check();
+
+	pr_debug("sys %u kHz, flash div %u, bus %u kHz: %s\n", prof->sys_khz,
+		 prof->flash_div, prof->bus_khz, ok ? "pass" : "fail");
+	return ok;
+}
+
+void autotune_set_bus_check(autotune_check_t check)
+{
+	bus_check = check;
+}
+
+int autotune_run(void)
+{
+	struct clock_profile prof;
+	uint32_t stage = STAGE_SYS, state;
+	uint32_t best_sys = IDX_NONE, best_bus = IDX_NONE;
+	uint32_t i;
+
+	if (autotune_resuming()) {
+		/* the candidate under test hung, carry on with the next stage */
+		state = watchdog_hw->scratch[SCRATCH_STATE];
+		best_sys = watchdog_hw->scratch[SCRATCH_BEST] >> 16;
+		best_bus = watchdog_hw->scratch[SCRATCH_BEST] & 0xffff;
+		stage = (state >> 16) + 1;
+		pr_debug("resuming, candidate %u of stage %u hung\n",
+			 state & 0xffff, state >> 16);
+	}
+
+	/* we are at safe clocks here, take the reference */
+	xip_ref_sum = autotune_sum((const uint32_t *)XIP_NOCACHE_NOALLOC_BASE,
+				   AUTOTUNE_XIP_SIZE / 4);
+
+	watchdog_hw->scratch[SCRATCH_MAGIC] = AUTOTUNE_MAGIC;
+	watchdog_hw->scratch[SCRATCH_BEST] = best_sys << 16 | best_bus;
+	watchdog_enable(AUTOTUNE_WDT_MS, true);
+
+	for (i = 0; stage == STAGE_SYS && i < ARRAY_SIZE(sys_khz_steps);
+	     i++) {
+		profile_from_best(&prof, i << 16 | best_bus);
+		if (!autotune_try(&prof, STAGE_SYS, i))
+			break;
+
+		best_sys = i;
+		watchdog_hw->scratch[SCRATCH_BEST] = best_sys << 16 | best_bus;
+	}
+
+	if (stage == STAGE_SYS)
+		stage = STAGE_BUS;
+
+	/* the bus can only be tuned if there is a way to verify it */
+	for (i = 0; stage == STAGE_BUS && bus_check && i < ARRAY_SIZE(bus_khz_steps);
+	     i++) {
+		/* the steps go up, the rest would all run at the limit */
+		if (i80_get_bus_clk_max_khz() &&
+		    bus_khz_steps[i] > i80_get_bus_clk_max_khz())
+			break;
+
+		profile_from_best(&prof, best_sys << 16 | i);
+		if (!autotune_try(&prof, STAGE_BUS, i))
+			break;
+
+		best_bus = i;
+		watchdog_hw->scratch[SCRATCH_BEST] = best_sys << 16 | best_bus;
+	}
+
+	hw_clear_bits(&watchdog_hw->ctrl, WATCHDOG_CTRL_ENABLE_BITS);
+	watchdog_hw->scratch[SCRATCH_MAGIC] = 0;
+
+	profile_from_best(&prof, best_sys << 16 | best_bus);
+	clock_profile_switch(&prof);
+
+	if (best_sys == IDX_NONE) {
+		pr_debug("no candidate passed, keeping CMake defaults\n");
+		return -1;
+	}
+
+	pr_debug("best: sys %u kHz, flash div %u, bus %u kHz\n", prof.sys_khz,
+		 prof.flash_div, prof.bus_khz);
+	return profile_store(&prof);
+}
+
+/* tune at boot when asked to, or when a previous run was cut short */
+void autotune_boot(void)
+{
+	const struct profile_record *rec =
+		(const struct profile_record *)(XIP_BASE + PROFILE_FLASH_OFFS);
+
+	if (autotune_resuming() ||
+	    (AUTOTUNE_AT_BOOT && !profile_record_valid(rec)))
+		autotune_run();
+}
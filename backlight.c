@@ -22,13 +22,52 @@
 #include <stdio.h>
 #include "hardware/gpio.h"
 #include "hardware/pwm.h"
+#include "hardware/dma.h"
+#include "hardware/clocks.h"
 
 #include "backlight.h"
 
+#define ARRAY_SIZE(arr) (sizeof(arr) / sizeof(arr[0]))
+
 #define BL_LVL_DEF_MIN	  0
 #define BL_LVL_DEF_MAX	  100
 #define BL_LVL_DEF_OFFSET 5
 #define BL_LVL_DEF_LVL	  100
+#define BL_LVL_DEF_FADE	  250
+
+/*
+ * Fades are a ramp of PWM compare words streamed into the slice CC register
+ * by a DMA channel paced by a DMA timer. The timer divides clk_sys by at most
+ * 65535, too fast for a ramp step, so a control channel re-arms the data
+ * channel per step and each step is written for several timer ticks.
+ */
+#define BL_FADE_STEPS	  128
+#define BL_FADE_TICK_HZ	  10000
+
+#ifndef BACKLIGHT_PWM_HZ
+#define BACKLIGHT_PWM_HZ  20025
+#endif
+
+/*
+ * Perceived brightness to duty, CIE 1931 lightness inverted, in 0..65535.
+ * Evaluated by the compiler, 256 steps so the low end moves in small
+ * increments where the eye is most sensitive.
+ */
+#define BL_LUT_SIZE 256
+#define BL_CIE_Y(l)                                                        \
+	((l) > 8.0 ? ((l) + 16.0) / 116.0 * ((l) + 16.0) / 116.0 *          \
+			     ((l) + 16.0) / 116.0 :                          \
+		     (l) / 903.3)
+#define BL_LUT(i) \
+	((u16)(BL_CIE_Y((i) * 100.0 / (BL_LUT_SIZE - 1)) * 65535.0 + 0.5))
+#define BL_LUT4(i)  BL_LUT(i), BL_LUT(i + 1), BL_LUT(i + 2), BL_LUT(i + 3)
+#define BL_LUT16(i) BL_LUT4(i), BL_LUT4(i + 4), BL_LUT4(i + 8), BL_LUT4(i + 12)
+#define BL_LUT64(i) \
+	BL_LUT16(i), BL_LUT16(i + 16), BL_LUT16(i + 32), BL_LUT16(i + 48)
+
+static const u16 bl_lut[BL_LUT_SIZE] = {
+	BL_LUT64(0), BL_LUT64(64), BL_LUT64(128), BL_LUT64(192),
+};
 
 struct backlight_device;
 
@@ -37,6 +76,7 @@ struct backlight_profile {
 	u8 bl_lvl_max;
 	u8 bl_lvl_offs;
 	u8 bl_lvl_default;
+	u16 fade_ms; /* used when the profile is loaded */
 };
 
 struct backlight_ops {
@@ -56,22 +96,199 @@ struct backlight_ops {
 	void (*bl_drv_update_cb)(struct backlight_device *dev);
 };
 
+struct backlight_fade_blk {
+	/* the order of al3_transfer_count and al3_read_addr_trig */
+	uint32_t count;
+	const uint32_t *read;
+};
+
 struct backlight_device {
 	u8 bl_pin;
 	u8 bl_lvl;
 
 	struct backlight_profile prof;
+
+	uint32_t pwm_hz;
+	u16 pwm_top; /* 0 until backlight_hw_init() */
+	bool off;
+	u16 gain; /* content adaptive, 256 is unity, see cabc.c */
+
+	int dma_data;
+	int dma_ctrl;
+	int dma_timer;
+	uint32_t ramp[BL_FADE_STEPS];
+	struct backlight_fade_blk blk[BL_FADE_STEPS + 1];
 } g_bl_priv;
 
-void __bl_set_lvl(struct backlight_device *dev, u8 level)
+/* pos is a LUT index in 1/256 steps, the duty in 0..65535 */
+static uint32_t __bl_pos_to_duty(uint pos)
+{
+	uint i = pos >> 8, frac = pos & 0xff;
+	uint32_t y = bl_lut[i];
+
+	if (frac && i < BL_LUT_SIZE - 1)
+		y += ((bl_lut[i + 1] - y) * frac) >> 8;
+
+	return y;
+}
+
+/* in pwm_top units, 65535 is top + 1, always high */
+static uint32_t __bl_pos_to_pwm(struct backlight_device *dev, uint pos)
+{
+	return __bl_pos_to_duty(pos) * (dev->pwm_top + 1u) / 65535;
+}
+
+static uint __bl_base_pos(u8 percent)
+{
+	return (percent * (BL_LUT_SIZE - 1) * 256 + 50) / 100;
+}
+
+/* the gain scales perceived brightness, not the duty */
+static uint __bl_percent_to_pos(struct backlight_device *dev, u8 percent)
+{
+	return __bl_base_pos(percent) * dev->gain >> 8;
+}
+
+static uint32_t __bl_percent_to_pwm(struct backlight_device *dev, u8 percent)
+{
+	return __bl_pos_to_pwm(dev, __bl_percent_to_pos(dev, percent));
+}
+
+/* the position whose duty is closest above pwm, for fades to start from */
+static uint __bl_pwm_to_pos(struct backlight_device *dev, uint32_t pwm)
+{
+	uint lo = 0, hi = (BL_LUT_SIZE - 1) * 256, mid;
+
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		if (__bl_pos_to_pwm(dev, mid) < pwm)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo;
+}
+
+static u8 __bl_clamp_percent(struct backlight_device *dev, u8 level)
 {
 	/* we shouldn't set backlight percent to 0%, otherwise we can't see nothing */
 	u8 percent = (level + dev->prof.bl_lvl_offs) > 100 ?
 			     100 :
 			     (level + dev->prof.bl_lvl_offs);
 
+	if (percent < dev->prof.bl_lvl_min)
+		percent = dev->prof.bl_lvl_min;
+	if (percent > dev->prof.bl_lvl_max)
+		percent = dev->prof.bl_lvl_max;
+
+	return percent;
+}
+
+static volatile uint32_t *__bl_cc(struct backlight_device *dev)
+{
+	return &pwm_hw->slice[pwm_gpio_to_slice_num(dev->bl_pin)].cc;
+}
+
+/*
+ * Stop a fade where it is. The data channel is unchained first, aborting it
+ * would otherwise trigger the control channel once more.
+ */
+static void __bl_fade_stop(struct backlight_device *dev)
+{
+	dma_channel_config c;
+
+	dma_channel_abort(dev->dma_ctrl);
+
+	c = dma_get_channel_config(dev->dma_data);
+	channel_config_set_chain_to(&c, dev->dma_data);
+	dma_channel_set_config(dev->dma_data, &c, false);
+	dma_channel_abort(dev->dma_data);
+
+	dma_channel_abort(dev->dma_ctrl);
+
+	channel_config_set_chain_to(&c, dev->dma_ctrl);
+	dma_channel_set_config(dev->dma_data, &c, false);
+}
+
+static float __bl_ease(enum backlight_ease ease, float t)
+{
+	switch (ease) {
+	case BL_EASE_IN_OUT:
+		return t * t * (3 - 2 * t);
+	case BL_EASE_OUT:
+		return 1 - (1 - t) * (1 - t);
+	case BL_EASE_LINEAR:
+	default:
+		return t;
+	}
+}
+
+/*
+ * The ramp runs along the LUT, in perceived brightness, so the eased steps
+ * look even. Both ends are the exact compare values, a fade ends on the same
+ * duty backlight_set_level() would set.
+ */
+static void __bl_fade_pwm(struct backlight_device *dev, uint to_pos,
+			  u16 duration_ms, enum backlight_ease ease)
+{
+	volatile uint32_t *cc = __bl_cc(dev);
+	uint shift = pwm_gpio_to_channel(dev->bl_pin) == PWM_CHAN_B ? 16 : 0;
+	uint32_t ticks, hold, keep;
+	uint32_t from, to;
+	int from_pos, i, steps;
+
+	to = __bl_pos_to_pwm(dev, to_pos);
+
+	__bl_fade_stop(dev);
+
+	keep = *cc & ~(0xffffu << shift);
+	from = (*cc >> shift) & 0xffff;
+
+	ticks = (uint32_t)duration_ms * BL_FADE_TICK_HZ / 1000;
+	if (!ticks || from == to) {
+		*cc = keep | (uint32_t)to << shift;
+		return;
+	}
+
+	steps = ticks < BL_FADE_STEPS ? ticks : BL_FADE_STEPS;
+	hold = ticks / steps;
+
+	from_pos = __bl_pwm_to_pos(dev, from);
+	for (i = 0; i < steps; i++) {
+		int pos = from_pos + (to_pos - from_pos) *
+					     __bl_ease(ease, (float)(i + 1) / steps);
+
+		dev->ramp[i] = keep | __bl_pos_to_pwm(dev, pos) << shift;
+		dev->blk[i].count = hold;
+		dev->blk[i].read = &dev->ramp[i];
+	}
+	dev->ramp[steps - 1] = keep | (uint32_t)to << shift;
+
+	/* a zero written to the trigger alias ends the list */
+	dev->blk[steps].count = 0;
+	dev->blk[steps].read = NULL;
+
+	/* clk_sys may have changed since the last fade */
+	dma_timer_set_fraction(dev->dma_timer, 1,
+			       clock_get_hz(clk_sys) / BL_FADE_TICK_HZ);
+
+	/* an aborted fade may have left the ring half way */
+	dma_channel_set_write_addr(dev->dma_ctrl,
+				   &dma_hw->ch[dev->dma_data].al3_transfer_count,
+				   false);
+	dma_channel_set_read_addr(dev->dma_ctrl, dev->blk, true);
+}
+
+void __bl_set_lvl(struct backlight_device *dev, u8 level)
+{
+	u8 percent = __bl_clamp_percent(dev, level);
+
+	__bl_fade_stop(dev);
+
 	/* To pwm level */
-	u16 pwm_lvl = (percent * 65535 / 100);
+	u16 pwm_lvl = __bl_percent_to_pwm(dev, percent);
+	dev->off = false;
 	pwm_set_gpio_level(dev->bl_pin, pwm_lvl);
 
 	dev->bl_lvl = percent;
@@ -82,6 +299,120 @@ void backlight_set_level(u8 level)
 	__bl_set_lvl(&g_bl_priv, level);
 }
 
+static void __bl_fade_to(struct backlight_device *dev, u8 level,
+			 u16 duration_ms, enum backlight_ease ease)
+{
+	u8 percent = __bl_clamp_percent(dev, level);
+
+	__bl_fade_pwm(dev, __bl_percent_to_pos(dev, percent), duration_ms,
+		      ease);
+	dev->off = false;
+
+	dev->bl_lvl = percent;
+}
+
+void backlight_fade_to(u8 level, u16 duration_ms, enum backlight_ease ease)
+{
+	__bl_fade_to(&g_bl_priv, level, duration_ms, ease);
+}
+
+bool backlight_fade_busy(void)
+{
+	return dma_channel_is_busy(g_bl_priv.dma_data) ||
+	       dma_channel_is_busy(g_bl_priv.dma_ctrl);
+}
+
+/*
+ * Scale the brightness by gain / 256 on top of the level, faded. Nothing is
+ * lit up while the power is off, the next power on uses the gain.
+ */
+void backlight_set_gain(u16 gain, u16 duration_ms)
+{
+	struct backlight_device *dev = &g_bl_priv;
+
+	if (gain > 256)
+		gain = 256;
+
+	dev->gain = gain;
+	if (!dev->off)
+		__bl_fade_pwm(dev, __bl_percent_to_pos(dev, dev->bl_lvl),
+			      duration_ms, BL_EASE_IN_OUT);
+}
+
+u16 backlight_get_gain(void)
+{
+	return g_bl_priv.gain;
+}
+
+/* in 0..65535, about proportional to the LED power, without the gain if !gained */
+uint32_t backlight_get_duty(bool gained)
+{
+	struct backlight_device *dev = &g_bl_priv;
+
+	if (dev->off)
+		return 0;
+
+	return __bl_pos_to_duty(gained ? __bl_percent_to_pos(dev, dev->bl_lvl) :
+					 __bl_base_pos(dev->bl_lvl));
+}
+
+/* the offset keeps level 0 visible, this really turns it off */
+void backlight_set_power(bool on)
+{
+	struct backlight_device *dev = &g_bl_priv;
+
+	__bl_fade_stop(dev);
+	pwm_set_gpio_level(dev->bl_pin,
+			   on ? __bl_percent_to_pwm(dev, dev->bl_lvl) : 0);
+	dev->off = !on;
+}
+
+/*
+ * The counter runs from clk_sys, top is kept below 65535 so the last LUT
+ * entry can be top + 1, fully on. The default frequency sits half way
+ * between two harmonics of the 90 Hz refresh, a beat with the panel scan
+ * would show up as rolling bands.
+ */
+static void __bl_set_pwm_freq(struct backlight_device *dev, uint32_t hz)
+{
+	uint slice_num = pwm_gpio_to_slice_num(dev->bl_pin);
+	uint32_t clk = clock_get_hz(clk_sys);
+	uint32_t div = clk / hz / 65535 + 1;
+
+	if (div > 255)
+		div = 255;
+
+	__bl_fade_stop(dev);
+
+	dev->pwm_hz = hz;
+	dev->pwm_top = clk / div / hz - 1;
+	pwm_set_clkdiv_int_frac(slice_num, div, 0);
+	pwm_set_wrap(slice_num, dev->pwm_top);
+
+	pwm_set_gpio_level(dev->bl_pin, dev->off ? 0 :
+			   __bl_percent_to_pwm(dev, dev->bl_lvl));
+}
+
+void backlight_set_pwm_freq(uint32_t hz)
+{
+	if (hz)
+		__bl_set_pwm_freq(&g_bl_priv, hz);
+}
+
+uint32_t backlight_get_pwm_freq(void)
+{
+	return g_bl_priv.pwm_hz;
+}
+
+/* after a clk_sys change, keeps the PWM frequency and the duty */
+void backlight_update_clk(void)
+{
+	struct backlight_device *dev = &g_bl_priv;
+
+	if (dev->pwm_top)
+		__bl_set_pwm_freq(dev, dev->pwm_hz);
+}
+
 static u8 __bl_get_lvl(struct backlight_device *dev)
 {
 	return dev->bl_lvl;
@@ -125,14 +456,55 @@ static void backlight_hw_init(struct backlight_device *dev)
 	pwm_init(slice_num, &config, true);
 
 	pwm_set_gpio_level(dev->bl_pin, 0);
+	dev->off = true;
+
+	dev->dma_data = dma_claim_unused_channel(true);
+	dev->dma_ctrl = dma_claim_unused_channel(true);
+	dev->dma_timer = dma_claim_unused_timer(true);
+
+	/* one compare word per timer tick, re-armed by the control channel */
+	dma_channel_config c = dma_channel_get_default_config(dev->dma_data);
+	channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+	channel_config_set_read_increment(&c, false);
+	channel_config_set_write_increment(&c, false);
+	channel_config_set_dreq(&c, dma_get_timer_dreq(dev->dma_timer));
+	channel_config_set_chain_to(&c, dev->dma_ctrl);
+	dma_channel_configure(dev->dma_data, &c, __bl_cc(dev), NULL, 0, false);
+
+	/* writes {count, read} of the next block, the last one is a null trigger */
+	c = dma_channel_get_default_config(dev->dma_ctrl);
+	channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+	channel_config_set_read_increment(&c, true);
+	channel_config_set_write_increment(&c, true);
+	channel_config_set_ring(&c, true, 3);
+	dma_channel_configure(dev->dma_ctrl, &c,
+			      &dma_hw->ch[dev->dma_data].al3_transfer_count,
+			      dev->blk, 2, false);
+
+	__bl_set_pwm_freq(dev, BACKLIGHT_PWM_HZ);
 }
 
 struct backlight_profile avaliable_profiles[] = {
-    [0] = {
+    [BL_PROFILE_NORMAL] = {
         .bl_lvl_min = 0,
         .bl_lvl_max = 100,
         .bl_lvl_offs = 5,
         .bl_lvl_default = 100,
+        .fade_ms = 250,
+    },
+    [BL_PROFILE_NIGHT] = {
+        .bl_lvl_min = 0,
+        .bl_lvl_max = 40,
+        .bl_lvl_offs = 1,
+        .bl_lvl_default = 15,
+        .fade_ms = 1000,
+    },
+    [BL_PROFILE_OUTDOOR] = {
+        .bl_lvl_min = 30,
+        .bl_lvl_max = 100,
+        .bl_lvl_offs = 5,
+        .bl_lvl_default = 100,
+        .fade_ms = 150,
     },
 };
 
@@ -143,6 +515,22 @@ static void backlight_load_profile(struct backlight_device *dev,
 	dev->prof.bl_lvl_max = profile->bl_lvl_max;
 	dev->prof.bl_lvl_offs = profile->bl_lvl_offs;
 	dev->prof.bl_lvl_default = profile->bl_lvl_default;
+	dev->prof.fade_ms = profile->fade_ms;
+}
+
+/* fades to the default level of the new profile */
+int backlight_set_profile(u8 id)
+{
+	struct backlight_device *dev = &g_bl_priv;
+
+	if (id >= ARRAY_SIZE(avaliable_profiles))
+		return -1;
+
+	backlight_load_profile(dev, &avaliable_profiles[id]);
+	__bl_fade_to(dev, dev->prof.bl_lvl_default, dev->prof.fade_ms,
+		     BL_EASE_IN_OUT);
+
+	return 0;
 }
 
 struct backlight_profile def_bl_profile = {
@@ -150,12 +538,14 @@ struct backlight_profile def_bl_profile = {
 	.bl_lvl_max = BL_LVL_DEF_MAX,
 	.bl_lvl_offs = BL_LVL_DEF_OFFSET,
 	.bl_lvl_default = BL_LVL_DEF_LVL,
+	.fade_ms = BL_LVL_DEF_FADE,
 };
 
 void backlight_driver_init(void)
 {
 	/* make default setting */
 	g_bl_priv.bl_pin = LCD_PIN_BL;
+	g_bl_priv.gain = 256;
 
 	backlight_load_profile(&g_bl_priv, &def_bl_profile);
 
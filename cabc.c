@@ -0,0 +1,185 @@
+// Copyright (c) 2026 embeddedboys developers
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#define pr_fmt(fmt) "cabc: " fmt
+
+#include <stdio.h>
+#include <string.h>
+
+#include "lvgl/lvgl.h"
+
+#include "ili9488.h"
+#include "backlight.h"
+#include "perf.h"
+#include "cabc.h"
+
+#if CABC_ENABLED
+
+#define DRV_NAME "cabc"
+
+#define pr_debug   printf
+#define __ram_func __attribute__((section(".time_critical." DRV_NAME)))
+
+#define CABC_BINS		 16
+#define CABC_ROW_STEP		 8 /* every 8th row */
+#define CABC_WORD_STEP		 4 /* every 4th pixel pair of a row */
+#define CABC_BRIGHT_PERMILLE	 20 /* the brightest 2% set the ceiling */
+#define CABC_HYST		 8
+#define CABC_REPORT_PERIOD_MS	 1000
+
+struct cabc_stats {
+	uint32_t frames;
+	uint32_t samples;
+	uint32_t duty; /* sums of the backlight duty, once per frame */
+	uint32_t base;
+};
+
+struct cabc {
+	uint32_t hist[CABC_BINS];
+	uint32_t samples;
+	uint32_t frame_samples; /* what sampling a whole screen gives */
+	uint32_t phase;
+
+	struct cabc_stats stats;
+} g_cabc;
+
+/*
+ * Luma of the two RGB565 pixels of a word at once, one per 16-bit half:
+ * Y = 19 R + 18 G + 7 B, about BT.601, at most 1940 so the halves never
+ * carry into each other.
+ */
+static inline uint32_t __ram_func cabc_luma2(uint32_t w)
+{
+	return ((w >> 11) & 0x001f001f) * 19 + ((w >> 5) & 0x003f003f) * 18 +
+	       (w & 0x001f001f) * 7;
+}
+
+void __ram_func cabc_sample(const void *px, int w, int h, int stride)
+{
+	struct cabc *cabc = &g_cabc;
+	const uint16_t *p;
+	const uint32_t *row;
+	uint32_t y;
+	int r, i, n;
+
+	PERF_SPAN_BEGIN(kernel);
+
+	for (r = cabc->phase; r < h; r += CABC_ROW_STEP) {
+		p = (const uint16_t *)px + r * stride;
+
+		/* an odd stride leaves every other row half word aligned */
+		n = w;
+		if ((uintptr_t)p & 2) {
+			p++;
+			n--;
+		}
+		row = (const uint32_t *)p;
+
+		for (i = 0; i < n / 2; i += CABC_WORD_STEP) {
+			y = cabc_luma2(row[i]);
+			cabc->hist[(y & 0xffff) >> 7]++;
+			cabc->hist[y >> 23]++;
+			cabc->samples += 2;
+		}
+	}
+
+	PERF_SPAN_END(PERF_SPAN_CABC, kernel);
+}
+
+/*
+ * The partial render mode only sends what changed, a frame is judged once
+ * about half a screen has been seen, so a small dark widget being redrawn
+ * doesn't dim the whole screen.
+ */
+void __ram_func cabc_frame_end(void)
+{
+	struct cabc *cabc = &g_cabc;
+	uint32_t bright = 0, gain;
+	int bin;
+
+	if (cabc->samples < cabc->frame_samples / 2)
+		return;
+
+	for (bin = CABC_BINS - 1; bin > 0; bin--) {
+		bright += cabc->hist[bin];
+		if (bright * 1000 > cabc->samples * CABC_BRIGHT_PERMILLE)
+			break;
+	}
+
+	gain = CABC_MIN_GAIN + (256 - CABC_MIN_GAIN) * (bin + 1) / CABC_BINS;
+	if (gain > backlight_get_gain() + CABC_HYST ||
+	    gain + CABC_HYST < backlight_get_gain() ||
+	    (gain == 256 && backlight_get_gain() != 256))
+		backlight_set_gain(gain, CABC_FADE_MS);
+
+	cabc->stats.frames++;
+	cabc->stats.samples += cabc->samples;
+	cabc->stats.duty += backlight_get_duty(true);
+	cabc->stats.base += backlight_get_duty(false);
+
+	memset(cabc->hist, 0, sizeof(cabc->hist));
+	cabc->samples = 0;
+	cabc->phase = (cabc->phase + 1) % CABC_ROW_STEP;
+}
+
+#if PERF_STATS_ENABLED
+/* the kernel time itself is the "cabc" perf span */
+static void cabc_report_cb(lv_timer_t *timer)
+{
+	struct cabc *cabc = &g_cabc;
+	struct cabc_stats s = cabc->stats;
+	uint32_t duty, base;
+
+	memset(&cabc->stats, 0, sizeof(cabc->stats));
+	if (!s.frames)
+		return;
+
+	/* in 0.1% */
+	duty = (uint64_t)s.duty * 1000 / s.frames / 65535;
+	base = (uint64_t)s.base * 1000 / s.frames / 65535;
+
+	pr_debug("cabc: %u frames, %u samples/frame, gain %u/256, backlight %u.%u%% instead of %u.%u%%, %u%% saved\n",
+		 s.frames, s.samples / s.frames, backlight_get_gain(),
+		 duty / 10, duty % 10, base / 10, base % 10,
+		 base ? (base - duty) * 100 / base : 0);
+}
+#endif
+
+/* the rendered resolution, it shrinks with halfres.c */
+void cabc_set_frame_size(int w, int h)
+{
+	g_cabc.frame_samples = h / CABC_ROW_STEP * (w / 2 / CABC_WORD_STEP) * 2;
+}
+
+void cabc_init(void)
+{
+	struct cabc *cabc = &g_cabc;
+
+	memset(cabc, 0, sizeof(*cabc));
+	cabc_set_frame_size(ili9488_get_xres(), ili9488_get_yres());
+
+#if PERF_STATS_ENABLED
+	lv_timer_create(cabc_report_cb, CABC_REPORT_PERIOD_MS, NULL);
+#endif
+}
+
+#endif
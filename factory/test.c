@@ -139,7 +139,8 @@ static void slider_backlight_event_cb(lv_event_t * e)
             label_dsc.font = font_normal;
             lv_draw_label(dsc->draw_ctx, &label_dsc, &txt_area, buf, NULL);
 
-            backlight_set_level(value);
+            /* follows the knob without stepping */
+            backlight_fade_to(value, 80, BL_EASE_OUT);
             lv_label_set_text_fmt(lbl, "Backlight level : %d", value);
         }
     }
@@ -23,21 +23,58 @@
 #include "pico/stdlib.h"
 #include "hardware/gpio.h"
 #include "hardware/i2c.h"
+#include "hardware/sync.h"
 
 #include "ili9488.h" /* where we get x,y resolution */
 #include "ft6236.h"
+#include "i2c_async.h"
 
 #define pr_debug printf
 
 #define FT6236_ADDR	 0x38
 #define FT6236_DEF_SPEED 400000
 
-typedef enum {
-	FT6236_DIR_NOP = 0x00,
-	FT6236_DIR_INVERT_X = 0x01,
-	FT6236_DIR_INVERT_Y = 0x02,
-	FT6236_DIR_SWITCH_XY = 0x04,
-} ft6236_direction_t;
+#define ONE (1 << TOUCH_MATRIX_SHIFT)
+
+/*
+ * Native panel coordinates to each LCD_ROTATE_*, the controller reports
+ * in the orientation of LCD_ROTATE_0 of the panel that was detected.
+ */
+static void ft6236_rot_matrix(struct touch_matrix *m, uint8_t rotate,
+			      int32_t xres, int32_t yres)
+{
+	switch (rotate) {
+	case LCD_ROTATE_90:
+		*m = (struct touch_matrix){
+			0, ONE, 0,
+			-ONE, 0, xres * ONE,
+		};
+		break;
+	case LCD_ROTATE_180:
+		*m = (struct touch_matrix){
+			-ONE, 0, xres * ONE,
+			0, -ONE, yres * ONE,
+		};
+		break;
+	case LCD_ROTATE_270:
+		*m = (struct touch_matrix){
+			0, -ONE, yres * ONE,
+			ONE, 0, 0,
+		};
+		break;
+	default:
+		*m = (struct touch_matrix){
+			ONE, 0, 0,
+			0, ONE, 0,
+		};
+		break;
+	}
+}
+
+static const struct touch_matrix touch_matrix_identity = {
+	ONE, 0, 0,
+	0, ONE, 0,
+};
 
 struct ft6236_data {
 	struct {
@@ -52,32 +89,44 @@ struct ft6236_data {
 	uint8_t irq_pin;
 	uint8_t rst_pin;
 
-	uint16_t x_res;
-	uint16_t y_res;
-
 	uint8_t rotate;
-	ft6236_direction_t dir; /* direction set */
-	bool invert_x;
-	bool invert_y;
-	uint16_t (*read_x)(struct ft6236_data *priv);
-	uint16_t (*read_y)(struct ft6236_data *priv);
+	struct touch_matrix rot; /* native panel to screen coordinates */
+	struct touch_matrix calib; /* raw to native panel coordinates */
+	struct touch_matrix xform; /* raw to screen, rotation * calib */
+	int16_t x_max;
+	int16_t y_max;
+
+	/* TD_STATUS, XH, XL, YH, YL in one background transaction */
+	struct {
+		struct i2c_xfer xfer;
+		uint8_t reg;
+		uint8_t buf[5];
+		volatile bool busy;
+
+		volatile uint32_t seq; /* odd while the result is updated */
+		bool pressed;
+		uint16_t x;
+		uint16_t y;
+		uint32_t t_us;
+	} poll;
 } g_ft6236_data;
 
 extern int i2c_bus_scan(i2c_inst_t *i2c);
 
 static void ft6236_write_reg(struct ft6236_data *priv, uint8_t reg, uint8_t val)
 {
-	uint16_t buf = val << 8 | reg;
-	i2c_write_blocking(priv->i2c.master, priv->i2c.addr, (uint8_t *)&buf,
-			   sizeof(buf), false);
+	uint8_t buf[2] = { reg, val };
+
+	i2c_async_write_read(priv->i2c.master, priv->i2c.addr, buf, sizeof(buf),
+			     NULL, 0);
 }
 #define write_reg ft6236_write_reg
 
 static uint8_t ft6236_read_reg(struct ft6236_data *priv, uint8_t reg)
 {
-	uint8_t val;
-	i2c_write_blocking(priv->i2c.master, priv->i2c.addr, &reg, 1, true);
-	i2c_read_blocking(priv->i2c.master, priv->i2c.addr, &val, 1, false);
+	uint8_t val = 0;
+
+	i2c_async_write_read(priv->i2c.master, priv->i2c.addr, &reg, 1, &val, 1);
 	return val;
 }
 #define read_reg ft6236_read_reg
@@ -92,37 +141,120 @@ static void __ft6236_reset(struct ft6236_data *priv)
 	sleep_ms(10);
 }
 
-static uint16_t __ft6236_read_x(struct ft6236_data *priv)
+/* one burst for XH, XL, YH, YL */
+static void __ft6236_read_raw(struct ft6236_data *priv, uint16_t *x,
+			      uint16_t *y)
 {
-	uint8_t val_h = read_reg(priv, FT_REG_TOUCH1_XH) &
-			0x1f; /* the MSB is always high, but it shouldn't */
-	uint8_t val_l = read_reg(priv, FT_REG_TOUCH1_XL);
-	uint16_t val = (val_h << 8) | val_l;
+	uint8_t reg = FT_REG_TOUCH1_XH;
+	uint8_t buf[4];
 
-	if (priv->invert_x)
-		return (priv->x_res - val);
+	i2c_async_write_read(priv->i2c.master, priv->i2c.addr, &reg, 1, buf,
+			     sizeof(buf));
 
-	return val;
+	/* only the low nibble of XH/YH is position, the rest is flags */
+	*x = (buf[0] & 0x0f) << 8 | buf[1];
+	*y = (buf[2] & 0x0f) << 8 | buf[3];
 }
 
-uint16_t ft6236_read_x(void)
+void ft6236_read_raw(uint16_t *x, uint16_t *y)
 {
-	return g_ft6236_data.read_x(&g_ft6236_data);
+	__ft6236_read_raw(&g_ft6236_data, x, y);
 }
 
-static uint16_t __ft6236_read_y(struct ft6236_data *priv)
+static inline int16_t ft6236_clamp(int32_t v, int16_t max)
 {
-	uint8_t val_h = read_reg(priv, FT_REG_TOUCH1_YH);
-	uint8_t val_l = read_reg(priv, FT_REG_TOUCH1_YL);
-	if (priv->invert_y)
-		return (priv->y_res - ((val_h << 8) | val_l));
-	else
-		return ((val_h << 8) | val_l);
+	return v < 0 ? 0 : v > max ? max : v;
+}
+
+static inline void ft6236_transform(struct ft6236_data *priv, uint16_t rx,
+				    uint16_t ry, uint16_t *x, uint16_t *y)
+{
+	const struct touch_matrix *m = &priv->xform;
+
+	*x = ft6236_clamp((m->xx * rx + m->xy * ry + m->x0) >>
+				  TOUCH_MATRIX_SHIFT,
+			  priv->x_max);
+	*y = ft6236_clamp((m->yx * rx + m->yy * ry + m->y0) >>
+				  TOUCH_MATRIX_SHIFT,
+			  priv->y_max);
+}
+
+void ft6236_read_xy(uint16_t *x, uint16_t *y)
+{
+	struct ft6236_data *priv = &g_ft6236_data;
+	uint16_t rx, ry;
+
+	__ft6236_read_raw(priv, &rx, &ry);
+	ft6236_transform(priv, rx, ry, x, y);
+}
+
+/* I2C interrupt */
+static void ft6236_poll_done(struct i2c_xfer *xfer)
+{
+	struct ft6236_data *priv = xfer->priv;
+	const uint8_t *buf = priv->poll.buf;
+
+	priv->poll.seq++;
+	if (xfer->status == PICO_OK) {
+		priv->poll.pressed = buf[0] & 0x0f;
+		ft6236_transform(priv, (buf[1] & 0x0f) << 8 | buf[2],
+				 (buf[3] & 0x0f) << 8 | buf[4], &priv->poll.x,
+				 &priv->poll.y);
+	} else {
+		priv->poll.pressed = false;
+	}
+	priv->poll.t_us = time_us_32();
+	__dmb();
+	priv->poll.seq++;
+
+	priv->poll.busy = false;
+}
+
+/* the result of the last background read, *t_us is when it was taken */
+bool ft6236_poll(uint16_t *x, uint16_t *y, uint32_t *t_us)
+{
+	struct ft6236_data *priv = &g_ft6236_data;
+	uint32_t seq;
+	bool pressed;
+
+	do {
+		seq = priv->poll.seq;
+		__dmb();
+		pressed = priv->poll.pressed;
+		*x = priv->poll.x;
+		*y = priv->poll.y;
+		*t_us = priv->poll.t_us;
+		__dmb();
+	} while ((seq & 1) || seq != priv->poll.seq);
+
+	return pressed;
+}
+
+/* start a background read unless one is on the way, IRQ safe */
+void ft6236_poll_start(void)
+{
+	struct ft6236_data *priv = &g_ft6236_data;
+
+	if (!priv->poll.busy) {
+		priv->poll.busy = true;
+		i2c_async_submit(priv->i2c.master, &priv->poll.xfer);
+	}
+}
+
+uint16_t ft6236_read_x(void)
+{
+	uint16_t x, y;
+
+	ft6236_read_xy(&x, &y);
+	return x;
 }
 
 uint16_t ft6236_read_y(void)
 {
-	return g_ft6236_data.read_y(&g_ft6236_data);
+	uint16_t x, y;
+
+	ft6236_read_xy(&x, &y);
+	return y;
 }
 
 static bool __ft6236_is_pressed(struct ft6236_data *priv)
@@ -136,56 +268,46 @@ bool ft6236_is_pressed(void)
 	return __ft6236_is_pressed(&g_ft6236_data);
 }
 
-static void __do_ft6236_set_dir(struct ft6236_data *priv,
-				ft6236_direction_t dir)
+/* out = a * b, both applied as a(b(p)) */
+static void touch_matrix_mul(struct touch_matrix *out,
+			     const struct touch_matrix *a,
+			     const struct touch_matrix *b)
 {
-	priv->dir = dir;
-
-	if (dir & FT6236_DIR_INVERT_X)
-		priv->invert_x = true;
-	else
-		priv->invert_x = false;
-
-	if (dir & FT6236_DIR_INVERT_Y)
-		priv->invert_y = true;
-	else
-		priv->invert_y = false;
+	struct touch_matrix m;
+
+	m.xx = ((int64_t)a->xx * b->xx + (int64_t)a->xy * b->yx) >>
+	       TOUCH_MATRIX_SHIFT;
+	m.xy = ((int64_t)a->xx * b->xy + (int64_t)a->xy * b->yy) >>
+	       TOUCH_MATRIX_SHIFT;
+	m.x0 = (((int64_t)a->xx * b->x0 + (int64_t)a->xy * b->y0) >>
+		TOUCH_MATRIX_SHIFT) + a->x0;
+	m.yx = ((int64_t)a->yx * b->xx + (int64_t)a->yy * b->yx) >>
+	       TOUCH_MATRIX_SHIFT;
+	m.yy = ((int64_t)a->yx * b->xy + (int64_t)a->yy * b->yy) >>
+	       TOUCH_MATRIX_SHIFT;
+	m.y0 = (((int64_t)a->yx * b->x0 + (int64_t)a->yy * b->y0) >>
+		TOUCH_MATRIX_SHIFT) + a->y0;
+
+	*out = m;
+}
 
-	if (dir & FT6236_DIR_SWITCH_XY) {
-		priv->read_x = __ft6236_read_y;
-		priv->read_y = __ft6236_read_x;
+/* the per sample work stays one multiply-add per term */
+static void ft6236_update_xform(struct ft6236_data *priv)
+{
+	int32_t xres = ili9488_get_native_xres();
+	int32_t yres = ili9488_get_native_yres();
 
-		priv->invert_x = !priv->invert_x;
-		priv->invert_y = !priv->invert_y;
+	ft6236_rot_matrix(&priv->rot, priv->rotate, xres, yres);
+	touch_matrix_mul(&priv->xform, &priv->rot, &priv->calib);
 
-		priv->x_res = ILI9488_Y_RES;
-		priv->y_res = ILI9488_X_RES;
-	} else {
-		priv->read_x = __ft6236_read_x;
-		priv->read_y = __ft6236_read_y;
-	}
+	priv->x_max = (priv->rotate & 1 ? yres : xres) - 1;
+	priv->y_max = (priv->rotate & 1 ? xres : yres) - 1;
 }
 
 void __ft6236_set_dir(struct ft6236_data *priv, uint8_t rotate)
 {
-	switch (rotate) {
-	case LCD_ROTATE_0:
-		priv->dir = 0;
-		break;
-	case LCD_ROTATE_90:
-		priv->dir = FT6236_DIR_SWITCH_XY | FT6236_DIR_INVERT_Y;
-		break;
-	case LCD_ROTATE_180:
-		priv->dir = FT6236_DIR_INVERT_X | FT6236_DIR_INVERT_Y;
-		break;
-	case LCD_ROTATE_270:
-		priv->dir = FT6236_DIR_SWITCH_XY | FT6236_DIR_INVERT_X;
-		break;
-	default:
-		break;
-	}
-
-	__do_ft6236_set_dir(&g_ft6236_data, priv->dir);
+	priv->rotate = rotate & 3;
+	ft6236_update_xform(priv);
 }
 
 void ft6236_set_dir(uint8_t rotate)
@@ -193,9 +315,23 @@ void ft6236_set_dir(uint8_t rotate)
 	__ft6236_set_dir(&g_ft6236_data, rotate);
 }
 
+const struct touch_matrix *ft6236_get_rotation_matrix(void)
+{
+	return &g_ft6236_data.rot;
+}
+
+/* NULL goes back to the raw controller coordinates */
+void ft6236_set_calibration(const struct touch_matrix *m)
+{
+	struct ft6236_data *priv = &g_ft6236_data;
+
+	priv->calib = m ? *m : touch_matrix_identity;
+	ft6236_update_xform(priv);
+}
+
 static void ft6236_hw_init(struct ft6236_data *priv)
 {
-	i2c_init(priv->i2c.master, FT6236_DEF_SPEED);
+	i2c_init(priv->i2c.master, priv->i2c.speed);
 
 	gpio_set_function(priv->i2c.scl_pin, GPIO_FUNC_I2C);
 	gpio_set_function(priv->i2c.sda_pin, GPIO_FUNC_I2C);
@@ -203,6 +339,8 @@ static void ft6236_hw_init(struct ft6236_data *priv)
 	gpio_pull_up(priv->i2c.scl_pin);
 	gpio_pull_up(priv->i2c.sda_pin);
 
+	i2c_async_init(priv->i2c.master);
+
 	gpio_init(priv->rst_pin);
 	gpio_set_dir(priv->rst_pin, GPIO_OUT);
 	gpio_pull_up(priv->rst_pin);
@@ -222,24 +360,68 @@ static int ft6236_probe(struct ft6236_data *priv)
 {
 	priv->i2c.master = i2c1;
 	priv->i2c.addr = FT6236_ADDR;
+	priv->i2c.speed = FT6236_DEF_SPEED;
 	priv->i2c.scl_pin = FT6236_PIN_SCL;
 	priv->i2c.sda_pin = FT6236_PIN_SDA;
 
 	priv->rst_pin = FT6236_PIN_RST;
 
-	priv->x_res = ILI9488_X_RES;
-	priv->y_res = ILI9488_Y_RES;
-
-	priv->invert_x = false;
-	priv->invert_y = false;
-
 	priv->rotate = LCD_ROTATION;
+	priv->calib = touch_matrix_identity;
+
+	priv->poll.reg = FT_REG_TD_STATUS;
+	priv->poll.xfer = (struct i2c_xfer){
+		.addr = FT6236_ADDR,
+		.tx_len = 1,
+		.rx_len = sizeof(priv->poll.buf),
+		.tx = &priv->poll.reg,
+		.rx = priv->poll.buf,
+		.cb = ft6236_poll_done,
+		.priv = priv,
+	};
 
 	ft6236_hw_init(priv);
 
 	return 0;
 }
 
+static bool ft6236_write_check(struct ft6236_data *priv, uint8_t reg,
+			       uint8_t val)
+{
+	write_reg(priv, reg, val);
+	if (read_reg(priv, reg) == val)
+		return true;
+
+	pr_debug("ft6236: reg 0x%02x is read-only on this part\n", reg);
+	return false;
+}
+
+/*
+ * Scan rate of the controller while touched, it drops to the monitor
+ * rate by itself after FT6236_MONITOR_S without a touch. Firmware builds
+ * differ in what they accept, whatever does not stick is reported.
+ */
+#define FT6236_MONITOR_S 2
+
+void ft6236_set_report_rate(unsigned int hz)
+{
+	struct ft6236_data *priv = &g_ft6236_data;
+	unsigned int val = hz / 10;
+
+	val = val < 3 ? 3 : val > 14 ? 14 : val;
+
+	ft6236_write_check(priv, FT_REG_PERIODACTIVE, val);
+	ft6236_write_check(priv, FT_REG_TIMEENTERMONITOR, FT6236_MONITOR_S);
+	ft6236_write_check(priv, FT_REG_CTRL, 1);
+}
+
+/* the i2c baudrate divider follows clk_sys, call this after changing it */
+void ft6236_update_clk(void)
+{
+	i2c_async_wait_idle(g_ft6236_data.i2c.master);
+	i2c_set_baudrate(g_ft6236_data.i2c.master, g_ft6236_data.i2c.speed);
+}
+
 int ft6236_driver_init(void)
 {
 	printf("ft6236_driver_init\n");
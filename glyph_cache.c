@@ -0,0 +1,377 @@
+// Copyright (c) 2026 embeddedboys developers
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include <stdio.h>
+#include <string.h>
+
+#include "lvgl/lvgl.h"
+
+#include "glyph_cache.h"
+
+#define DRV_NAME "glyph_cache"
+
+#define pr_debug   printf
+#define __ram_func __attribute__((section(".time_critical." DRV_NAME)))
+
+#if GLYPH_CACHE_SIZE
+
+typedef unsigned int u32;
+typedef unsigned char u8;
+
+#define GLYPH_CACHE_SLOTS (GLYPH_CACHE_SIZE / GLYPH_CACHE_SLOT)
+#define GLYPH_CACHE_HASH  64
+#define GLYPH_NONE	  0xff
+
+#define GLYPH_CACHE_REPORT_PERIOD_MS 5000
+
+/* a colour glyph is built from its A8 one, both must fit at once */
+#if GLYPH_CACHE_SLOTS < 2 || GLYPH_CACHE_SLOTS >= GLYPH_NONE
+#error "GLYPH_CACHE_SIZE must hold 2 to 254 slots"
+#endif
+
+enum glyph_type {
+	GLYPH_A8,
+	GLYPH_RGB, /* lv_color_t, RGB565 or RGB332 */
+};
+
+struct glyph_key {
+	const lv_font_t *font;
+	u32 letter;
+	lv_color_t color; /* GLYPH_RGB only */
+	lv_color_t bg;
+	u8 type;
+};
+
+struct glyph_entry {
+	struct glyph_key key;
+	u32 used; /* LRU tick, 0 for a free slot */
+	u8 next; /* hash chain */
+};
+
+static struct glyph_entry entries[GLYPH_CACHE_SLOTS];
+static u8 slots[GLYPH_CACHE_SLOTS][GLYPH_CACHE_SLOT] __attribute__((aligned(4)));
+static u8 buckets[GLYPH_CACHE_HASH];
+static u32 glyph_tick;
+static struct glyph_cache_stats stats;
+
+static void (*sw_draw_letter)(lv_draw_ctx_t *draw_ctx,
+			      const lv_draw_label_dsc_t *dsc,
+			      const lv_point_t *pos_p, uint32_t letter);
+
+static inline u32 glyph_hash(const struct glyph_key *key)
+{
+	u32 h = (uintptr_t)key->font ^ key->letter * 2654435761u;
+
+	h ^= (key->color.full * 65599u ^ key->bg.full) * 40503u + key->type;
+	return (h ^ h >> 16) % GLYPH_CACHE_HASH;
+}
+
+static inline bool glyph_key_eq(const struct glyph_key *a,
+				const struct glyph_key *b)
+{
+	return a->font == b->font && a->letter == b->letter &&
+	       a->color.full == b->color.full && a->bg.full == b->bg.full &&
+	       a->type == b->type;
+}
+
+static u8 *__ram_func glyph_cache_find(const struct glyph_key *key)
+{
+	u8 i;
+
+	for (i = buckets[glyph_hash(key)]; i != GLYPH_NONE; i = entries[i].next) {
+		if (glyph_key_eq(&entries[i].key, key)) {
+			entries[i].used = ++glyph_tick;
+			return slots[i];
+		}
+	}
+
+	return NULL;
+}
+
+static void glyph_cache_unlink(u8 idx)
+{
+	u8 *p = &buckets[glyph_hash(&entries[idx].key)];
+
+	while (*p != idx)
+		p = &entries[*p].next;
+	*p = entries[idx].next;
+}
+
+/* reuse the least recently used slot */
+static u8 *__ram_func glyph_cache_alloc(const struct glyph_key *key)
+{
+	u32 h = glyph_hash(key);
+	u8 i, lru = 0;
+
+	for (i = 0; i < GLYPH_CACHE_SLOTS; i++) {
+		if (entries[i].used < entries[lru].used)
+			lru = i;
+		if (!entries[lru].used)
+			break;
+	}
+
+	if (entries[lru].used) {
+		glyph_cache_unlink(lru);
+		stats.evict++;
+	}
+
+	entries[lru].key = *key;
+	entries[lru].used = ++glyph_tick;
+	entries[lru].next = buckets[h];
+	buckets[h] = lru;
+
+	return slots[lru];
+}
+
+static inline lv_opa_t glyph_bpp_to_opa(u8 v, u8 bpp)
+{
+	switch (bpp) {
+	case 1:
+		return v ? LV_OPA_COVER : LV_OPA_TRANSP;
+	case 2:
+		return v * 85;
+	case 4:
+		return v * 17;
+	case 8:
+		return v;
+	default:
+		return v * 255 / ((1 << bpp) - 1);
+	}
+}
+
+/* the font bitmap expanded to one opa byte per pixel */
+static const u8 *__ram_func glyph_cache_get_a8(const lv_font_glyph_dsc_t *g,
+					       u32 letter)
+{
+	struct glyph_key key = {
+		.font = g->resolved_font,
+		.letter = letter,
+		.type = GLYPH_A8,
+	};
+	u32 i, bit, count = g->box_w * g->box_h;
+	const u8 *map;
+	u8 *a8, mask = (1 << g->bpp) - 1;
+
+	a8 = glyph_cache_find(&key);
+	if (a8) {
+		stats.a8_hit++;
+		return a8;
+	}
+
+	map = lv_font_get_glyph_bitmap(g->resolved_font, letter);
+	if (!map)
+		return NULL;
+
+	stats.a8_miss++;
+	a8 = glyph_cache_alloc(&key);
+
+	if (g->bpp == 8) {
+		memcpy(a8, map, count);
+		return a8;
+	}
+
+	/* rows are packed without padding, as in lv_draw_sw_letter() */
+	for (i = 0, bit = 0; i < count; i++, bit += g->bpp)
+		a8[i] = glyph_bpp_to_opa(map[bit >> 3] >> (8 - g->bpp - (bit & 7)) & mask,
+					 g->bpp);
+
+	return a8;
+}
+
+/* the software blender skips and covers at the same thresholds */
+static inline lv_color_t glyph_mix(lv_color_t fg, lv_color_t bg, lv_opa_t a)
+{
+	if (a >= LV_OPA_MAX)
+		return fg;
+	if (a <= LV_OPA_MIN)
+		return bg;
+	return lv_color_mix(fg, bg, a);
+}
+
+static const lv_color_t *__ram_func
+glyph_cache_get_rgb(const lv_font_glyph_dsc_t *g, u32 letter, lv_color_t color,
+		    lv_color_t bg)
+{
+	struct glyph_key key = {
+		.font = g->resolved_font,
+		.letter = letter,
+		.color = color,
+		.bg = bg,
+		.type = GLYPH_RGB,
+	};
+	u32 i, count = g->box_w * g->box_h;
+	lv_color_t *px;
+	const u8 *a8;
+
+	px = (lv_color_t *)glyph_cache_find(&key);
+	if (px) {
+		stats.rgb_hit++;
+		return px;
+	}
+
+	a8 = glyph_cache_get_a8(g, letter);
+	if (!a8)
+		return NULL;
+
+	/* the A8 slot was just used, it is not the one reused here */
+	stats.rgb_miss++;
+	px = (lv_color_t *)glyph_cache_alloc(&key);
+
+	for (i = 0; i < count; i++)
+		px[i] = glyph_mix(color, bg, a8[i]);
+
+	return px;
+}
+
+/* the background under the visible part of the glyph, if it is one colour */
+static bool __ram_func glyph_bg_uniform(lv_draw_ctx_t *draw_ctx,
+					const lv_area_t *clip, lv_color_t *bg)
+{
+	lv_coord_t stride = lv_area_get_width(draw_ctx->buf_area);
+	lv_coord_t w = lv_area_get_width(clip), x, y;
+	lv_color_t *p = (lv_color_t *)draw_ctx->buf +
+			(clip->y1 - draw_ctx->buf_area->y1) * stride +
+			(clip->x1 - draw_ctx->buf_area->x1);
+	lv_color_t c = p[0];
+
+	for (y = clip->y1; y <= clip->y2; y++) {
+		for (x = 0; x < w; x++)
+			if (p[x].full != c.full)
+				return false;
+		p += stride;
+	}
+
+	*bg = c;
+	return true;
+}
+
+static void __ram_func glyph_cache_draw_letter(lv_draw_ctx_t *draw_ctx,
+					       const lv_draw_label_dsc_t *dsc,
+					       const lv_point_t *pos_p,
+					       uint32_t letter)
+{
+	lv_draw_sw_blend_dsc_t blend;
+	lv_font_glyph_dsc_t g;
+	lv_area_t area, clip;
+	lv_color_t bg;
+	const lv_color_t *px = NULL;
+	const u8 *a8 = NULL;
+	u32 count;
+
+	/* placeholders, subpixel fonts and such are left to LVGL */
+	if (!lv_font_get_glyph_dsc(dsc->font, &g, letter, '\0') ||
+	    !g.box_w || !g.box_h || g.bpp > 8 ||
+	    g.resolved_font->subpx != LV_FONT_SUBPX_NONE ||
+	    dsc->opa < LV_OPA_MAX || dsc->blend_mode != LV_BLEND_MODE_NORMAL)
+		goto bypass;
+
+	count = g.box_w * g.box_h;
+	if (count > GLYPH_CACHE_SLOT)
+		goto bypass;
+
+	area.x1 = pos_p->x + g.ofs_x;
+	area.y1 = pos_p->y + (dsc->font->line_height - dsc->font->base_line) -
+		  g.box_h - g.ofs_y;
+	area.x2 = area.x1 + g.box_w - 1;
+	area.y2 = area.y1 + g.box_h - 1;
+
+	if (!_lv_area_intersect(&clip, &area, draw_ctx->clip_area))
+		return;
+
+	if (lv_draw_mask_is_any(&area))
+		goto bypass;
+
+	if (count * sizeof(lv_color_t) <= GLYPH_CACHE_SLOT &&
+	    glyph_bg_uniform(draw_ctx, &clip, &bg))
+		px = glyph_cache_get_rgb(&g, letter, dsc->color, bg);
+	if (!px)
+		a8 = glyph_cache_get_a8(&g, letter);
+	if (!px && !a8)
+		goto bypass;
+
+	lv_memset_00(&blend, sizeof(blend));
+	blend.blend_area = &area;
+	blend.opa = LV_OPA_COVER;
+	blend.blend_mode = LV_BLEND_MODE_NORMAL;
+
+	if (px) {
+		blend.src_buf = px;
+		blend.mask_res = LV_DRAW_MASK_RES_FULL_COVER;
+	} else {
+		blend.color = dsc->color;
+		blend.mask_buf = (lv_opa_t *)a8;
+		blend.mask_area = &area;
+		blend.mask_res = LV_DRAW_MASK_RES_CHANGED;
+	}
+
+	lv_draw_sw_blend(draw_ctx, &blend);
+	return;
+
+bypass:
+	stats.bypass++;
+	sw_draw_letter(draw_ctx, dsc, pos_p, letter);
+}
+
+void glyph_cache_get_stats(struct glyph_cache_stats *s)
+{
+	*s = stats;
+}
+
+void glyph_cache_report(void)
+{
+	u32 hit = stats.a8_hit + stats.rgb_hit;
+	u32 all = hit + stats.a8_miss + stats.rgb_miss;
+
+	pr_debug("%s: rgb %u/%u, a8 %u/%u hit/miss, %u evicted, %u bypassed, hit %u%%\n",
+		 DRV_NAME, stats.rgb_hit, stats.rgb_miss, stats.a8_hit,
+		 stats.a8_miss, stats.evict, stats.bypass,
+		 all ? hit * 100 / all : 0);
+}
+
+#if PERF_STATS_ENABLED
+static void glyph_cache_report_cb(lv_timer_t *timer)
+{
+	glyph_cache_report();
+}
+#endif
+
+/* Call after lv_disp_drv_register(), replaces the letter renderer */
+void glyph_cache_init(lv_disp_t *disp)
+{
+	lv_draw_ctx_t *draw_ctx = disp->driver->draw_ctx;
+
+	memset(entries, 0, sizeof(entries));
+	memset(buckets, GLYPH_NONE, sizeof(buckets));
+
+	sw_draw_letter = draw_ctx->draw_letter;
+	draw_ctx->draw_letter = glyph_cache_draw_letter;
+
+	pr_debug("%s: %d slots of %d bytes\n", DRV_NAME, GLYPH_CACHE_SLOTS,
+		 GLYPH_CACHE_SLOT);
+
+#if PERF_STATS_ENABLED
+	lv_timer_create(glyph_cache_report_cb, GLYPH_CACHE_REPORT_PERIOD_MS,
+			NULL);
+#endif
+}
+
+#endif
@@ -0,0 +1,77 @@
+// Copyright (c) 2026 embeddedboys developers
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+
+#include <stdint.h>
+
+#include "ili9488.h"
+#include "cabc.h"
+#include "halfres.h"
+
+#if HALFRES_ENABLED
+
+static bool g_halfres;
+
+void halfres_set(lv_disp_t *disp, bool on)
+{
+	lv_disp_drv_t *drv = disp->driver;
+
+	if (on == g_halfres)
+		return;
+
+	/* the last flush has to land in the old mode */
+	ili9488_video_flush_wait();
+
+	g_halfres = on;
+
+	/* re-layouts the screens and invalidates them */
+	drv->hor_res = ili9488_get_xres() >> on;
+	drv->ver_res = ili9488_get_yres() >> on;
+	cabc_set_frame_size(drv->hor_res, drv->ver_res);
+	lv_disp_drv_update(disp, drv);
+}
+
+bool halfres_get(void)
+{
+	return g_halfres;
+}
+
+static void halfres_load_cb(lv_event_t *e)
+{
+	lv_obj_t *scr = lv_event_get_target(e);
+
+	halfres_set(lv_obj_get_disp(scr),
+		    (bool)(uintptr_t)lv_event_get_user_data(e));
+}
+
+void halfres_screen(lv_obj_t *scr, bool on)
+{
+	lv_disp_t *disp = lv_obj_get_disp(scr);
+
+	lv_obj_add_event_cb(scr, halfres_load_cb, LV_EVENT_SCREEN_LOAD_START,
+			    (void *)(uintptr_t)on);
+
+	if (scr == lv_disp_get_scr_act(disp))
+		halfres_set(disp, on);
+}
+
+#endif
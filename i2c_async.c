@@ -0,0 +1,239 @@
+// Copyright (c) 2026 embeddedboys developers
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#define pr_fmt(fmt) "i2c_async: " fmt
+
+#include <stdio.h>
+
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+
+#include "i2c_async.h"
+
+#define pr_debug printf
+
+struct i2c_async {
+	i2c_inst_t *i2c;
+	int tx_chan; /* 16 bit commands into IC_DATA_CMD */
+	int rx_chan; /* bytes out of it */
+	spin_lock_t *lock; /* the queue, submitters may be on either core */
+	uint32_t abort; /* IC_TX_ABRT_SOURCE of the running transaction */
+
+	struct i2c_xfer *head; /* running */
+	struct i2c_xfer *tail;
+
+	uint16_t cmd[I2C_ASYNC_MAX_LEN];
+};
+
+static struct i2c_async g_i2c_async[NUM_I2CS];
+
+static inline struct i2c_async *i2c_async_of(i2c_inst_t *i2c)
+{
+	return &g_i2c_async[i2c_get_index(i2c)];
+}
+
+/* the bus is idle, the caller holds the lock */
+static void i2c_async_start(struct i2c_async *ia, struct i2c_xfer *xfer)
+{
+	i2c_hw_t *hw = i2c_get_hw(ia->i2c);
+	int i, n = 0;
+
+	for (i = 0; i < xfer->tx_len; i++)
+		ia->cmd[n++] = xfer->tx[i];
+
+	for (i = 0; i < xfer->rx_len; i++)
+		ia->cmd[n++] = I2C_IC_DATA_CMD_CMD_BITS |
+			       (i == 0 && xfer->tx_len ?
+					I2C_IC_DATA_CMD_RESTART_BITS :
+					0);
+
+	ia->cmd[n - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+
+	/* the target address can only change while disabled */
+	hw->enable = 0;
+	hw->tar = xfer->addr;
+	hw->enable = 1;
+
+	ia->abort = 0;
+	if (xfer->rx_len)
+		dma_channel_transfer_to_buffer_now(ia->rx_chan, xfer->rx,
+						   xfer->rx_len);
+	dma_channel_transfer_from_buffer_now(ia->tx_chan, ia->cmd, n);
+}
+
+/* every transaction ends with a stop, aborted ones included */
+static void __isr i2c_async_irq(struct i2c_async *ia)
+{
+	i2c_hw_t *hw = i2c_get_hw(ia->i2c);
+	uint32_t stat = hw->intr_stat;
+	struct i2c_xfer *xfer = ia->head;
+	i2c_xfer_cb_t cb;
+	uint32_t save;
+	int status;
+
+	if (stat & I2C_IC_INTR_STAT_R_TX_ABRT_BITS) {
+		ia->abort = hw->tx_abrt_source;
+		dma_channel_abort(ia->tx_chan);
+		dma_channel_abort(ia->rx_chan);
+		(void)hw->clr_tx_abrt;
+	}
+
+	if (!(stat & I2C_IC_INTR_STAT_R_STOP_DET_BITS))
+		return;
+	(void)hw->clr_stop_det;
+
+	if (!xfer)
+		return;
+
+	/* the last byte may still be on its way out of the RX FIFO */
+	while (!ia->abort && dma_channel_is_busy(ia->rx_chan))
+		tight_loop_contents();
+
+	cb = xfer->cb;
+	status = ia->abort ? PICO_ERROR_GENERIC : PICO_OK;
+
+	save = spin_lock_blocking(ia->lock);
+	ia->head = xfer->next;
+	if (ia->head)
+		i2c_async_start(ia, ia->head);
+	else
+		ia->tail = NULL;
+	spin_unlock(ia->lock, save);
+
+	/* a blocking submitter may return and reuse xfer from here on */
+	xfer->status = status;
+	if (cb)
+		cb(xfer);
+}
+
+static void __isr i2c0_async_irq(void)
+{
+	i2c_async_irq(&g_i2c_async[0]);
+}
+
+static void __isr i2c1_async_irq(void)
+{
+	i2c_async_irq(&g_i2c_async[1]);
+}
+
+int i2c_async_submit(i2c_inst_t *i2c, struct i2c_xfer *xfer)
+{
+	struct i2c_async *ia = i2c_async_of(i2c);
+	uint32_t save;
+
+	if (!ia->lock || !(xfer->tx_len + xfer->rx_len) ||
+	    xfer->tx_len + xfer->rx_len > I2C_ASYNC_MAX_LEN)
+		return PICO_ERROR_INVALID_ARG;
+
+	xfer->status = I2C_ASYNC_PENDING;
+	xfer->next = NULL;
+
+	save = spin_lock_blocking(ia->lock);
+	if (ia->tail) {
+		ia->tail->next = xfer;
+	} else {
+		ia->head = xfer;
+		i2c_async_start(ia, xfer);
+	}
+	ia->tail = xfer;
+	spin_unlock(ia->lock, save);
+
+	return PICO_OK;
+}
+
+void i2c_async_wait_idle(i2c_inst_t *i2c)
+{
+	struct i2c_async *ia = i2c_async_of(i2c);
+
+	while (*(struct i2c_xfer *volatile *)&ia->head)
+		tight_loop_contents();
+}
+
+/* drop-in for the blocking SDK calls, queued behind everything else */
+int i2c_async_write_read(i2c_inst_t *i2c, uint8_t addr, const uint8_t *tx,
+			 size_t tx_len, uint8_t *rx, size_t rx_len)
+{
+	struct i2c_xfer xfer = {
+		.addr = addr,
+		.tx_len = tx_len,
+		.rx_len = rx_len,
+		.tx = tx,
+		.rx = rx,
+	};
+	int ret;
+
+	ret = i2c_async_submit(i2c, &xfer);
+	if (ret)
+		return ret;
+
+	while (xfer.status == I2C_ASYNC_PENDING)
+		tight_loop_contents();
+
+	return xfer.status;
+}
+
+/* after i2c_init(), the IRQ is taken on the calling core */
+int i2c_async_init(i2c_inst_t *i2c)
+{
+	struct i2c_async *ia = i2c_async_of(i2c);
+	i2c_hw_t *hw = i2c_get_hw(i2c);
+	dma_channel_config c;
+	uint irq = I2C0_IRQ + i2c_get_index(i2c);
+
+	if (ia->lock)
+		return 0;
+
+	ia->i2c = i2c;
+	ia->tx_chan = dma_claim_unused_channel(true);
+	ia->rx_chan = dma_claim_unused_channel(true);
+	ia->lock = spin_lock_instance(spin_lock_claim_unused(true));
+
+	c = dma_channel_get_default_config(ia->tx_chan);
+	channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+	channel_config_set_read_increment(&c, true);
+	channel_config_set_write_increment(&c, false);
+	channel_config_set_dreq(&c, i2c_get_dreq(i2c, true));
+	dma_channel_configure(ia->tx_chan, &c, &hw->data_cmd, NULL, 0, false);
+
+	c = dma_channel_get_default_config(ia->rx_chan);
+	channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+	channel_config_set_read_increment(&c, false);
+	channel_config_set_write_increment(&c, true);
+	channel_config_set_dreq(&c, i2c_get_dreq(i2c, false));
+	dma_channel_configure(ia->rx_chan, &c, NULL, &hw->data_cmd, 0, false);
+
+	hw->dma_cr = I2C_IC_DMA_CR_TDMAE_BITS | I2C_IC_DMA_CR_RDMAE_BITS;
+	hw->intr_mask = I2C_IC_INTR_MASK_M_STOP_DET_BITS |
+			I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+	(void)hw->clr_intr;
+
+	irq_set_exclusive_handler(irq, i2c_get_index(i2c) ? i2c1_async_irq :
+							    i2c0_async_irq);
+	irq_set_enabled(irq, true);
+
+	pr_debug("i2c%d: DMA channels %d/%d\n", i2c_get_index(i2c),
+		 ia->tx_chan, ia->rx_chan);
+	return 0;
+}
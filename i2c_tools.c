@@ -2,6 +2,8 @@
 #include "hardware/gpio.h"
 #include "hardware/i2c.h"
 
+#include "i2c_async.h"
+
 bool reserved_addr(uint8_t addr)
 {
 	return (addr & 0x78) == 0 || (addr & 0x78) == 0x78;
@@ -12,6 +14,9 @@ int i2c_bus_scan(i2c_inst_t *i2c)
 	if (!i2c)
 		i2c = i2c0;
 
+	/* shares the bus with whoever queued transactions on it */
+	i2c_async_init(i2c);
+
 	printf("\nI2C Bus Scan\n");
 	printf("   0  1  2  3  4  5  6  7  8  9  A  B  C  D  E  F\n");
 
@@ -21,9 +26,9 @@ int i2c_bus_scan(i2c_inst_t *i2c)
 		}
 
 		// Perform a 1-byte dummy read from the probe address. If a slave
-		// acknowledges this address, the function returns the number of bytes
-		// transferred. If the address byte is ignored, the function returns
-		// -1.
+		// acknowledges this address, the function returns 0. If the
+		// address byte is ignored, the transfer aborts and it returns
+		// a negative error.
 
 		// Skip over any reserved addresses.
 		int ret;
@@ -31,7 +36,8 @@ int i2c_bus_scan(i2c_inst_t *i2c)
 		if (reserved_addr(addr))
 			ret = -1;
 		else
-			ret = i2c_read_blocking(i2c, addr, &rxdata, 1, false);
+			ret = i2c_async_write_read(i2c, addr, NULL, 0, &rxdata,
+						   1);
 
 		printf(ret < 0 ? "." : "@");
 		printf(addr % 16 == 15 ? "\n" : "  ");
@@ -0,0 +1,79 @@
+// Copyright (c) 2026 embeddedboys developers
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include <stdint.h>
+
+#include "ili9488.h"
+#include "lcd_seq.h"
+#include "lcd_panel.h"
+
+/* Ilitek ILI9341, 240x320 */
+
+static const uint8_t ili9341_madctl[] = {
+	[LCD_ROTATE_0] = MX | BGR,
+	[LCD_ROTATE_90] = MV | BGR,
+	[LCD_ROTATE_180] = MY | BGR,
+	[LCD_ROTATE_270] = MX | MY | MV | BGR,
+};
+
+static const uint32_t ili9341_init_seq[] = {
+	LCD_SEQ_REG(0xEF, 0x03, 0x80, 0x02),
+	LCD_SEQ_REG(0xCF, 0x00, 0xC1, 0x30), // Power Control B
+	LCD_SEQ_REG(0xED, 0x64, 0x03, 0x12, 0x81), // Power On Sequence Control
+	LCD_SEQ_REG(0xE8, 0x85, 0x00, 0x78), // Driver Timing Control A
+	LCD_SEQ_REG(0xCB, 0x39, 0x2C, 0x00, 0x34, 0x02), // Power Control A
+	LCD_SEQ_REG(0xF7, 0x20), // Pump Ratio Control
+	LCD_SEQ_REG(0xEA, 0x00, 0x00), // Driver Timing Control B
+	LCD_SEQ_REG(0xC0, 0x23), // Power Control 1
+	LCD_SEQ_REG(0xC1, 0x10), // Power Control 2
+	LCD_SEQ_REG(0xC5, 0x3E, 0x28), // VCOM Control 1
+	LCD_SEQ_REG(0xC7, 0x86), // VCOM Control 2
+	LCD_SEQ_REG(0x37, 0x00), // Vertical Scrolling Start Address
+	LCD_SEQ_REG(0xB1, 0x00, 0x18), // Frame Rate Control, 79Hz
+	LCD_SEQ_REG(0xB6, 0x08, 0x82, 0x27), // Display Function Control
+	LCD_SEQ_REG(0xF2, 0x00), // 3Gamma Function Disable
+	LCD_SEQ_REG(0x26, 0x01), // Gamma Set
+
+	// Positive Gamma Correction
+	LCD_SEQ_REG(0xE0, 0x0F, 0x31, 0x2B, 0x0C, 0x0E, 0x08, 0x4E, 0xF1,
+		    0x37, 0x07, 0x10, 0x03, 0x0E, 0x09, 0x00),
+	// Negative Gamma Correction
+	LCD_SEQ_REG(0xE1, 0x00, 0x0E, 0x14, 0x03, 0x11, 0x07, 0x31, 0xC1,
+		    0x48, 0x08, 0x0F, 0x0C, 0x31, 0x36, 0x0F),
+
+	LCD_SEQ_CMD(0x11), // Sleep Out
+	LCD_SEQ_DELAY_MS(120),
+	LCD_SEQ_CMD(0x29), // Display on
+};
+
+const struct lcd_controller lcd_ili9341 = {
+	.name = "ili9341",
+	.type = LCD_CTRL_ILI9341,
+	.id = 0x009341,
+	.xres = 240,
+	.yres = 320,
+	.madctl = ili9341_madctl,
+	.init_seq = ili9341_init_seq,
+	.init_len = sizeof(ili9341_init_seq) / sizeof(ili9341_init_seq[0]),
+	.pixfmts = LCD_PIXFMT_RGB565 | LCD_PIXFMT_RGB666,
+	.wr_khz_max = 15000, /* tWC 66 ns */
+};
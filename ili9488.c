@@ -33,6 +33,8 @@
 #include "hardware/gpio.h"
 
 #include "ili9488.h"
+#include "lcd_seq.h"
+#include "lcd_panel.h"
 
 /*
  * ili9488 Command Table
@@ -84,14 +86,31 @@ struct ili9488_priv {
 	/* device specific */
 	const struct ili9488_operations *tftops;
 	struct ili9488_display *display;
+	const struct lcd_controller *ctrl;
+
+	uint64_t sleep_in_us; /* SLPIN and SLPOUT have to be 120 ms apart */
 } g_priv;
 
 #define ARRAY_SIZE(arr)		(sizeof(arr) / sizeof(arr[0]))
 #define dm_gpio_set_value(p, v) gpio_put(p, v)
 #define mdelay(v)		sleep_ms(v)
 
-extern int i80_pio_init(uint8_t db_base, uint8_t db_count, uint8_t pin_wr);
+extern int i80_pio_init(uint8_t db_base, uint8_t db_count, uint8_t pin_wr,
+			uint8_t pin_rd);
 extern int i80_write_buf_rs(void *buf, size_t len, bool rs);
+extern int i80_read_buf_rs(void *buf, size_t len, bool rs);
+extern void i80_write_buf_rs_async(void *buf, size_t len, bool rs);
+extern void i80_write_wait(void);
+extern void i80_write_stream(const uint32_t *words, size_t count);
+extern void i80_write_stream_blk_async(const struct lcd_seq_blk *blk,
+				       size_t n);
+extern void i80_write_buf_x2_async(const void *buf, size_t w, size_t h,
+				   size_t stride);
+extern void i80_set_clut(const uint16_t *clut);
+extern void i80_write_buf_clut(const void *buf, size_t w, size_t h,
+			       size_t stride);
+extern void i80_set_bus_clk_max_khz(uint32_t khz);
+extern uint32_t i80_get_bus_clk_khz(void);
 
 static void __ram_func fbtft_write_gpio16_wr(struct ili9488_priv *priv,
 					     void *buf, size_t len)
@@ -158,6 +177,28 @@ static void __ram_func fbtft_write_gpio16_wr_rs(struct ili9488_priv *priv,
 #define write_buf_rs(p, b, l, r) fbtft_write_gpio16_wr_rs(p, b, l, r)
 #endif
 
+#if DISP_OVER_PIO && LCD_PIN_DB_COUNT == 8
+/*
+ * The pixel state machine strobes twice per 16-bit word, commands and
+ * parameters take one strobe each, so they go out as a stream.
+ */
+static int __ram_func ili9488_write_reg(struct ili9488_priv *priv, int len, ...)
+{
+	u32 seq[16];
+	va_list args;
+	int i;
+
+	va_start(args, len);
+	seq[0] = LCD_SEQ_CMD(va_arg(args, unsigned int) & 0xff);
+	for (i = 1; i < len; i++)
+		seq[i] = LCD_SEQ_DAT(va_arg(args, unsigned int) & 0xff);
+	va_end(args);
+
+	i80_write_stream(seq, len);
+
+	return 0;
+}
+#else
 static int __ram_func ili9488_write_reg(struct ili9488_priv *priv, int len, ...)
 {
 	u16 *buf = (u16 *)priv->buf;
@@ -184,6 +225,7 @@ static int __ram_func ili9488_write_reg(struct ili9488_priv *priv, int len, ...)
 
 	return 0;
 }
+#endif
 #define NUMARGS(...) (sizeof((int[]){ __VA_ARGS__ }) / sizeof(int))
 #define write_reg(priv, ...) \
 	ili9488_write_reg(priv, NUMARGS(__VA_ARGS__), __VA_ARGS__)
@@ -199,63 +241,134 @@ static int ili9488_reset(struct ili9488_priv *priv)
 	return 0;
 }
 
-static int ili9488_init_display(struct ili9488_priv *priv)
+/*
+ * Runs a sequence built with lcd_seq.h, the PIO bus sends it as one stream,
+ * the GPIO one walks it.
+ */
+static void ili9488_write_seq(struct ili9488_priv *priv, const u32 *seq,
+			      size_t len)
 {
-	pr_debug("%s, writing initial sequence...\n", __func__);
-	ili9488_reset(priv);
-	// dm_gpio_set_value(&priv->gpio.rd, 1);
-	// mdelay(150);
+#if DISP_OVER_PIO
+	i80_write_stream(seq, len);
+#else
+	u16 val;
 
+	while (len--) {
+		if (LCD_SEQ_IS_DELAY(*seq)) {
+			sleep_us(LCD_SEQ_US(*seq));
+		} else {
+			val = LCD_SEQ_VAL(*seq);
+			write_buf_rs(priv, &val, sizeof(val), LCD_SEQ_RS(*seq));
+		}
+		seq++;
+	}
+#endif
+}
+
+static const u32 ili9488_init_seq[] = {
 	// Positive Gamma Control
-	write_reg(priv, 0xE0, 0x00, 0x03, 0x09, 0x08, 0x16, 0x0A, 0x3F, 0x78,
-		  0x4C, 0x09, 0x0A, 0x08, 0x16, 0x1A, 0x0F);
+	LCD_SEQ_REG(0xE0, 0x00, 0x03, 0x09, 0x08, 0x16, 0x0A, 0x3F, 0x78,
+		    0x4C, 0x09, 0x0A, 0x08, 0x16, 0x1A, 0x0F),
 
 	// Negative Gamma Control
-	write_reg(priv, 0xE1, 0x00, 0x16, 0x19, 0x03, 0x0F, 0x05, 0x32, 0x45,
-		  0x46, 0x04, 0x0E, 0x0D, 0x35, 0x37, 0x0F);
+	LCD_SEQ_REG(0xE1, 0x00, 0x16, 0x19, 0x03, 0x0F, 0x05, 0x32, 0x45,
+		    0x46, 0x04, 0x0E, 0x0D, 0x35, 0x37, 0x0F),
 
-	write_reg(priv, 0xC0, 0x17, 0x15); // Power Control 1
-	write_reg(priv, 0xC1, 0x41); // Power Control 2
-	write_reg(priv, 0xC5, 0x00, 0x12, 0x80); // VCOM Control
-	// write_reg(priv, 0x36, 0x28);                // Memory Access Control
-	write_reg(priv, 0x3A,
-		  0x55); // Pixel Interface Format RGB565 8080 16-bit
-	write_reg(priv, 0xB0, 0x00); // Interface Mode Control
+	LCD_SEQ_REG(0xC0, 0x17, 0x15), // Power Control 1
+	LCD_SEQ_REG(0xC1, 0x41), // Power Control 2
+	LCD_SEQ_REG(0xC5, 0x00, 0x12, 0x80), // VCOM Control
+	// LCD_SEQ_REG(0x36, 0x28),                // Memory Access Control
+	LCD_SEQ_REG(0xB0, 0x00), // Interface Mode Control
 
 	// Frame Rate Control
-	// write_reg(priv, 0xB1, 0xD0, 0x11);       // 60Hz
-	write_reg(priv, 0xB1, 0xD0, 0x14); // 90Hz
+	// LCD_SEQ_REG(0xB1, 0xD0, 0x11),       // 60Hz
+	LCD_SEQ_REG(0xB1, 0xD0, 0x14), // 90Hz
+
+	LCD_SEQ_REG(0xB4, 0x02), // Display Inversion Control
+	LCD_SEQ_REG(0xB6, 0x02, 0x02, 0x3B), // Display Function Control
+	LCD_SEQ_REG(0xB7, 0xC6), // Entry Mode Set
+	LCD_SEQ_REG(0xF7, 0xA9, 0x51, 0x2C, 0x82), // Adjust Control 3
+#if CABC_PANEL_MODE
+	LCD_SEQ_REG(0x51, 0xFF), // Display Brightness
+	LCD_SEQ_REG(0x53, 0x2C), // CTRL Display, BCTRL, DD, BL on
+	LCD_SEQ_REG(0x55, CABC_PANEL_MODE), // Content Adaptive Brightness
+#endif
+	LCD_SEQ_CMD(0x11), // Exit Sleep
+	LCD_SEQ_DELAY_MS(60),
+	LCD_SEQ_CMD(0x29), // Display on
+};
 
-	write_reg(priv, 0xB4, 0x02); // Display Inversion Control
-	write_reg(priv, 0xB6, 0x02, 0x02, 0x3B); // Display Function Control
-	write_reg(priv, 0xB7, 0xC6); // Entry Mode Set
-	write_reg(priv, 0xF7, 0xA9, 0x51, 0x2C, 0x82); // Adjust Control 3
-	write_reg(priv, 0x11); // Exit Sleep
-	mdelay(60);
-	write_reg(priv, 0x29); // Display on
+/* MADCTL of each LCD_ROTATE_* */
+static const u8 ili9488_madctl[] = {
+	[LCD_ROTATE_0] = MX | BGR,
+	[LCD_ROTATE_90] = MV | BGR,
+	[LCD_ROTATE_180] = MY | BGR,
+	[LCD_ROTATE_270] = MX | MY | MV | BGR,
+};
+
+const struct lcd_controller lcd_ili9488 = {
+	.name = "ili9488",
+	.type = LCD_CTRL_ILI9488,
+	.id = 0x009488,
+	.xres = ILI9488_NATIVE_X_RES,
+	.yres = ILI9488_NATIVE_Y_RES,
+	.madctl = ili9488_madctl,
+	.init_seq = ili9488_init_seq,
+	.init_len = ARRAY_SIZE(ili9488_init_seq),
+	.pixfmts = LCD_PIXFMT_RGB565 | LCD_PIXFMT_RGB666,
+};
+
+/*
+ * Pixel formats by bus writes per pixel on this bus, fastest first. LVGL
+ * renders RGB565 and the flush DMA sends the draw buffer as it is, so only
+ * the formats in ILI9488_FLUSH_PIXFMTS can be picked.
+ */
+#define ILI9488_FLUSH_PIXFMTS LCD_PIXFMT_RGB565
+
+static const struct {
+	u8 fmt;
+	u8 colmod;
+} ili9488_pixfmt_pref[] = {
+	{ LCD_PIXFMT_RGB565, LCD_COLMOD_RGB565 }, /* 1 write */
+	{ LCD_PIXFMT_RGB666, LCD_COLMOD_RGB666 }, /* 1.5, 3 for 2 pixels */
+	{ LCD_PIXFMT_RGB888, LCD_COLMOD_RGB888 }, /* 1.5 */
+};
+
+static u8 ili9488_pick_colmod(const struct lcd_controller *ctrl)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(ili9488_pixfmt_pref); i++)
+		if (ctrl->pixfmts & ILI9488_FLUSH_PIXFMTS &
+		    ili9488_pixfmt_pref[i].fmt)
+			return ili9488_pixfmt_pref[i].colmod;
+
+	pr_debug("%s takes no format the flush path has, trying RGB565\n",
+		 ctrl->name);
+	return LCD_COLMOD_RGB565;
+}
+
+/* the panel is out of reset, COLMOD is accepted in sleep mode already */
+static int ili9488_init_display(struct ili9488_priv *priv)
+{
+	const struct lcd_controller *ctrl = priv->ctrl;
+	u32 t0 = time_us_32();
+
+	pr_debug("%s, writing initial sequence...\n", __func__);
+	// dm_gpio_set_value(&priv->gpio.rd, 1);
+	// mdelay(150);
 
+	write_reg(priv, 0x3A, ili9488_pick_colmod(ctrl)); // Pixel Format Set
+	ili9488_write_seq(priv, ctrl->init_seq, ctrl->init_len);
+
+	pr_debug("%s, %s sequence %u us\n", __func__, ctrl->name,
+		 time_us_32() - t0);
 	return 0;
 }
 
 static int ili9488_set_dir(struct ili9488_priv *priv, u8 dir)
 {
-	switch (dir) {
-	case LCD_ROTATE_0:
-		write_reg(priv, MADCTL, MX | BGR);
-		break;
-	case LCD_ROTATE_90:
-		write_reg(priv, MADCTL, MV | BGR);
-		break;
-	case LCD_ROTATE_180:
-		write_reg(priv, MADCTL, MY | BGR);
-		break;
-	case LCD_ROTATE_270:
-		write_reg(priv, MADCTL, MX | MY | MV | BGR);
-		break;
-	default:
-		break;
-	}
-
+	write_reg(priv, MADCTL, priv->ctrl->madctl[dir & 3]);
 	return 0;
 }
 
@@ -294,15 +407,29 @@ static int ili9488_clear(struct ili9488_priv *priv, u16 clear)
 	return 0;
 }
 
+/* the panel stops showing GRAM, which is kept */
 static int ili9488_blank(struct ili9488_priv *priv, bool on)
 {
-	pr_debug("%s\n", __func__);
+	write_reg(priv, on ? 0x28 : 0x29); // Display off/on
 	return 0;
 }
 
+/* stops the oscillator and the DC/DC converter, GRAM is kept */
 static int ili9488_sleep(struct ili9488_priv *priv, bool on)
 {
-	pr_debug("%s\n", __func__);
+	uint64_t since = time_us_64() - priv->sleep_in_us;
+
+	if (on) {
+		write_reg(priv, 0x10); // Sleep in
+		priv->sleep_in_us = time_us_64();
+	} else {
+		if (since < 120000)
+			sleep_us(120000 - since);
+		write_reg(priv, 0x11); // Sleep out
+	}
+
+	/* no command for 5 ms after either one */
+	mdelay(5);
 	return 0;
 }
 
@@ -342,25 +469,10 @@ static int ili9488_gpio_init(struct ili9488_priv *priv)
 		gpio_set_dir(*pp, GPIO_OUT);
 		pp++;
 	}
-#endif
-	return 0;
-}
-
-static int ili9488_hw_init(struct ili9488_priv *priv)
-{
-	printf("initializing hardware...\n");
 
-#if DISP_OVER_PIO
-	i80_pio_init(priv->gpio.db[0], ARRAY_SIZE(priv->gpio.db),
-		     priv->gpio.wr);
+	/* RD is active low, keep the panel out of read mode */
+	dm_gpio_set_value(priv->gpio.rd, 1);
 #endif
-	ili9488_gpio_init(priv);
-
-	priv->tftops->init_display(priv);
-	priv->tftops->set_dir(priv, priv->display->rotate);
-	/* clear screen to black */
-	// priv->tftops->clear(priv, 0x0);
-
 	return 0;
 }
 
@@ -371,6 +483,49 @@ static struct ili9488_display default_ili9488_display = {
 	.rotate = LCD_ROTATION,
 };
 
+/*
+ * Change the scan direction of the panel, the resolution follows. GRAM is
+ * not redrawn, the caller has to invalidate the screen.
+ */
+void ili9488_set_rotation(uint8_t rotate)
+{
+	struct ili9488_priv *priv = &g_priv;
+	struct ili9488_display *display = priv->display;
+
+	rotate &= 3;
+	display->rotate = rotate;
+	display->xres = rotate & 1 ? priv->ctrl->yres : priv->ctrl->xres;
+	display->yres = rotate & 1 ? priv->ctrl->xres : priv->ctrl->yres;
+
+	priv->tftops->set_dir(priv, rotate);
+}
+
+uint8_t ili9488_get_rotation(void)
+{
+	return g_priv.display->rotate;
+}
+
+uint32_t ili9488_get_xres(void)
+{
+	return g_priv.display->xres;
+}
+
+uint32_t ili9488_get_yres(void)
+{
+	return g_priv.display->yres;
+}
+
+/* of the detected controller in LCD_ROTATE_0, the ILI9488 before probing */
+uint32_t ili9488_get_native_xres(void)
+{
+	return g_priv.ctrl ? g_priv.ctrl->xres : ILI9488_NATIVE_X_RES;
+}
+
+uint32_t ili9488_get_native_yres(void)
+{
+	return g_priv.ctrl ? g_priv.ctrl->yres : ILI9488_NATIVE_Y_RES;
+}
+
 static void __ram_func ili9488_video_sync(struct ili9488_priv *priv, int xs,
 					  int ys, int xe, int ye, void *vmem16,
 					  size_t len)
@@ -386,6 +541,362 @@ void __ram_func ili9488_video_flush(int xs, int ys, int xe, int ye,
 	ili9488_video_sync(&g_priv, xs, ys, xe, ye, vmem16, len);
 }
 
+/*
+ * Like ili9488_video_flush() but returns as soon as the DMA is started, so
+ * the caller can prepare the next buffer meanwhile. `vmem16` must not be
+ * touched until ili9488_video_flush_wait(), the next flush waits by itself.
+ */
+void __ram_func ili9488_video_flush_async(int xs, int ys, int xe, int ye,
+					  void *vmem16, uint32_t len)
+{
+#if DISP_OVER_PIO
+	struct ili9488_priv *priv = &g_priv;
+
+	priv->tftops->set_addr_win(priv, xs, ys, xe, ye);
+	i80_write_buf_rs_async(vmem16, len, 1);
+#else
+	ili9488_video_flush(xs, ys, xe, ye, vmem16, len);
+#endif
+}
+
+#if DISP_OVER_PIO
+/*
+ * Half resolution, the area and `vmem16` are in half resolution pixels with
+ * lines `stride` pixels apart, each one lands on the panel as a 2x2 block.
+ * Returns once started, like ili9488_video_flush_async().
+ */
+void __ram_func ili9488_video_flush_x2_async(int xs, int ys, int xe, int ye,
+					     void *vmem16, uint32_t stride)
+{
+	struct ili9488_priv *priv = &g_priv;
+
+	priv->tftops->set_addr_win(priv, xs * 2, ys * 2, xe * 2 + 1,
+				   ye * 2 + 1);
+	i80_write_buf_x2_async(vmem16, xe - xs + 1, ye - ys + 1, stride);
+}
+
+/*
+ * 8-bit indexed pixels, `vmem8` holds the area with lines `stride` pixels
+ * apart, they are expanded through the colour table on the way out.
+ */
+void __ram_func ili9488_video_flush_clut(int xs, int ys, int xe, int ye,
+					 void *vmem8, uint32_t stride)
+{
+	struct ili9488_priv *priv = &g_priv;
+
+	priv->tftops->set_addr_win(priv, xs, ys, xe, ye);
+	i80_write_buf_clut(vmem8, xe - xs + 1, ye - ys + 1, stride);
+}
+
+/* the 256 RGB565 colours indexed pixels stand for */
+void ili9488_set_clut(const u16 *clut)
+{
+	i80_set_clut(clut);
+}
+#endif
+
+void __ram_func ili9488_video_flush_wait(void)
+{
+#if DISP_OVER_PIO
+	i80_write_wait();
+#endif
+}
+
+/*
+ * Flush a sub-rectangle of a framebuffer whose lines are `stride` pixels
+ * apart, e.g. an invalidated area of the persistent LVGL framebuffer.
+ */
+void __ram_func ili9488_video_flush_area(int xs, int ys, int xe, int ye,
+					 void *vmem16, uint32_t stride)
+{
+	struct ili9488_priv *priv = &g_priv;
+	u16 *p = (u16 *)vmem16 + ys * stride + xs;
+	size_t line_len = (xe - xs + 1) * sizeof(u16);
+	int y;
+
+	priv->tftops->set_addr_win(priv, xs, ys, xe, ye);
+
+	/* full width lines are contiguous, send them in one go */
+	if (xs == 0 && xe == stride - 1) {
+		write_buf_rs(priv, p, line_len * (ye - ys + 1), 1);
+		return;
+	}
+
+	for (y = ys; y <= ye; y++) {
+		write_buf_rs(priv, p, line_len, 1);
+		p += stride;
+	}
+}
+
+#if DISP_OVER_PIO && LCD_PIN_DB_COUNT == 16
+#define BATCH_MAX_AREAS 32
+#define BATCH_MAX_BLKS	512
+
+/*
+ * The areas of one refresh, each is a window block followed by a block per
+ * line (one when the lines are contiguous), sent with a single kick.
+ */
+static struct {
+	u32 win[BATCH_MAX_AREAS][12];
+	struct lcd_seq_blk blk[BATCH_MAX_BLKS + 1];
+	int areas, blks;
+} g_batch;
+
+/*
+ * Queue an area of a framebuffer that stays untouched until
+ * ili9488_video_flush_wait(), like the persistent one of direct mode. The
+ * columns are widened to even ones so every line is whole words, `vmem16`
+ * must be 4 byte aligned and `stride` even.
+ */
+void __ram_func ili9488_video_batch_add(int xs, int ys, int xe, int ye,
+					void *vmem16, uint32_t stride)
+{
+	const u16 *p;
+	u32 *win;
+	int w, h, nr_blks, y;
+
+	xs &= ~1;
+	xe |= 1;
+	w = xe - xs + 1;
+	h = ye - ys + 1;
+	nr_blks = (xs == 0 && w == (int)stride) ? 2 : h + 1;
+
+	if (g_batch.areas == BATCH_MAX_AREAS ||
+	    g_batch.blks + nr_blks > BATCH_MAX_BLKS)
+		ili9488_video_batch_kick();
+
+	/* the previous batch may still be read */
+	if (!g_batch.areas)
+		i80_write_wait();
+
+	if (nr_blks > BATCH_MAX_BLKS) {
+		ili9488_video_flush_area(xs, ys, xe, ye, vmem16, stride);
+		return;
+	}
+
+	win = g_batch.win[g_batch.areas++];
+	win[0] = LCD_SEQ_CMD(0x2A);
+	win[1] = LCD_SEQ_DAT(xs >> 8);
+	win[2] = LCD_SEQ_DAT(xs & 0xff);
+	win[3] = LCD_SEQ_DAT(xe >> 8);
+	win[4] = LCD_SEQ_DAT(xe & 0xff);
+	win[5] = LCD_SEQ_CMD(0x2B);
+	win[6] = LCD_SEQ_DAT(ys >> 8);
+	win[7] = LCD_SEQ_DAT(ys & 0xff);
+	win[8] = LCD_SEQ_DAT(ye >> 8);
+	win[9] = LCD_SEQ_DAT(ye & 0xff);
+	win[10] = LCD_SEQ_CMD(0x2C);
+	win[11] = LCD_SEQ_RUN(w * h);
+	g_batch.blk[g_batch.blks++] = (struct lcd_seq_blk){ 12, win };
+
+	p = (const u16 *)vmem16 + ys * stride + xs;
+	if (nr_blks == 2) {
+		g_batch.blk[g_batch.blks++] =
+			(struct lcd_seq_blk){ w * h / 2, p };
+		return;
+	}
+
+	for (y = ys; y <= ye; y++) {
+		g_batch.blk[g_batch.blks++] = (struct lcd_seq_blk){ w / 2, p };
+		p += stride;
+	}
+}
+
+/*
+ * Start sending the queued areas and return, ili9488_video_flush_wait()
+ * tells when the framebuffer may be drawn to again.
+ */
+void __ram_func ili9488_video_batch_kick(void)
+{
+	if (!g_batch.areas)
+		return;
+
+	g_batch.blk[g_batch.blks] = (struct lcd_seq_blk){ 0, NULL };
+	i80_write_stream_blk_async(g_batch.blk, g_batch.blks);
+	g_batch.areas = 0;
+	g_batch.blks = 0;
+}
+#else
+/* the 8-bit bus would need every pixel split in two, flush them one by one */
+void __ram_func ili9488_video_batch_add(int xs, int ys, int xe, int ye,
+					void *vmem16, uint32_t stride)
+{
+	ili9488_video_flush_area(xs, ys, xe, ye, vmem16, stride);
+}
+
+void ili9488_video_batch_kick(void)
+{
+}
+#endif
+
+#if DISP_OVER_PIO
+/* reads back `len` words after the dummy one every read command starts with */
+static int ili9488_read_reg(struct ili9488_priv *priv, u16 reg, u16 *buf,
+			    size_t len)
+{
+	u16 dummy;
+
+	write_reg(priv, reg);
+	i80_read_buf_rs(&dummy, sizeof(dummy), 1);
+	return i80_read_buf_rs(buf, len * sizeof(u16), 1);
+}
+
+/* Read ID4 (0xD3) returns 0x00, 0x94, 0x88 on the lower 8 bits */
+void ili9488_set_blank(bool blank)
+{
+	g_priv.tftops->blank(&g_priv, blank);
+}
+
+void ili9488_set_sleep(bool sleep)
+{
+	g_priv.tftops->sleep(&g_priv, sleep);
+}
+
+u32 ili9488_read_id(void)
+{
+	u16 id[3];
+
+	ili9488_read_reg(&g_priv, 0xD3, id, ARRAY_SIZE(id));
+
+	return (id[0] & 0xff) << 16 | (id[1] & 0xff) << 8 | (id[2] & 0xff);
+}
+
+/*
+ * GRAM is read back as RGB666 whatever the pixel format, 2 pixels in 3
+ * words with one colour per byte in its upper 6 bits, or one colour per
+ * read cycle on the 8-bit bus. With BGR set in MADCTL the panel hands back
+ * blue first.
+ */
+static inline u16 rgb666_to_rgb565(u8 r, u8 g, u8 b)
+{
+	return (r & 0xf8) << 8 | (g & 0xfc) << 3 | b >> 3;
+}
+
+#define GRAM_RD_CHUNK 32 /* pixels per memory read command, must be even */
+
+int ili9488_read_gram(int xs, int ys, int xe, int ye, u16 *buf)
+{
+	struct ili9488_priv *priv = &g_priv;
+	u32 left = (xe - xs + 1) * (ye - ys + 1);
+	u16 cmd = 0x2E; /* memory read, then memory read continue */
+	u32 n, i;
+#if LCD_PIN_DB_COUNT == 8
+	u16 words[GRAM_RD_CHUNK * 3];
+#else
+	u16 words[GRAM_RD_CHUNK * 3 / 2];
+	u8 *c;
+#endif
+
+	priv->tftops->set_addr_win(priv, xs, ys, xe, ye);
+
+	while (left) {
+		n = left < GRAM_RD_CHUNK ? left : GRAM_RD_CHUNK;
+
+#if LCD_PIN_DB_COUNT == 8
+		ili9488_read_reg(priv, cmd, words, n * 3);
+		cmd = 0x3E;
+
+		/* the upper byte is whatever sits on the pins above the bus */
+		for (i = 0; i < n; i++)
+			*buf++ = rgb666_to_rgb565(words[i * 3 + 2] & 0xff,
+						  words[i * 3 + 1] & 0xff,
+						  words[i * 3] & 0xff);
+#else
+		ili9488_read_reg(priv, cmd, words, (n * 3 + 1) / 2);
+		cmd = 0x3E;
+
+		/* bus order is the high byte of each word first */
+		c = (u8 *)words;
+		for (i = 0; i < n; i++)
+			*buf++ = rgb666_to_rgb565(c[(i * 3 + 2) ^ 1],
+						  c[(i * 3 + 1) ^ 1],
+						  c[(i * 3) ^ 1]);
+#endif
+
+		left -= n;
+	}
+
+	return 0;
+}
+
+/*
+ * Write a pattern and read it back, used to verify the bus at the clocks
+ * picked by the autotuner. Red and blue are kept equal so the result does
+ * not depend on the BGR order. What the pattern covers is read first, at
+ * the fixed RD clock, and put back afterwards so nothing shows on screen.
+ */
+bool ili9488_bus_check(void)
+{
+	static u16 wr[256], rd[256], saved[256];
+	bool ok = true;
+	u32 x = 0x2545f491;
+	u16 v;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(wr); i++) {
+		x ^= x << 13, x ^= x >> 17, x ^= x << 5;
+		v = x & 0x1f;
+		wr[i] = v << 11 | ((x >> 8) & 0x3f) << 5 | v;
+	}
+
+	ili9488_read_gram(0, 0, 31, 7, saved);
+	ili9488_video_flush(0, 0, 31, 7, wr, sizeof(wr));
+	ili9488_read_gram(0, 0, 31, 7, rd);
+
+	for (i = 0; i < ARRAY_SIZE(wr); i++)
+		if (rd[i] != wr[i])
+			ok = false;
+
+	ili9488_video_flush(0, 0, 31, 7, saved, sizeof(saved));
+	return ok;
+}
+
+/* ########### benchmark ######## */
+#define BENCH_BAND_LINES 20
+#define BENCH_FRAMES     20
+
+/*
+ * Effective pixel rate of full screen flushes at the current WR clock, one
+ * strobe per pixel on the 16-bit bus and two on the 8-bit one.
+ */
+void ili9488_bus_benchmark(void)
+{
+	u32 xres = ili9488_get_xres(), yres = ili9488_get_yres();
+	u32 start, us, y, h, i;
+	uint64_t px;
+	u16 *band;
+
+	band = malloc(xres * BENCH_BAND_LINES * sizeof(u16));
+	if (!band) {
+		pr_debug("benchmark out of memory\n");
+		return;
+	}
+
+	for (i = 0; i < xres * BENCH_BAND_LINES; i++)
+		band[i] = i;
+
+	start = time_us_32();
+	for (i = 0; i < BENCH_FRAMES; i++) {
+		for (y = 0; y < yres; y += h) {
+			h = yres - y < BENCH_BAND_LINES ? yres - y :
+							   BENCH_BAND_LINES;
+			ili9488_video_flush(0, y, xres - 1, y + h - 1, band,
+					    xres * h * sizeof(u16));
+		}
+	}
+	us = time_us_32() - start;
+
+	px = (uint64_t)xres * yres * BENCH_FRAMES;
+	pr_debug("%d-bit bus, WR %u kHz: %llu px/s, %llu.%llu fps\n",
+		 LCD_PIN_DB_COUNT, (u32)i80_get_bus_clk_khz(), px * 1000000 / us,
+		 BENCH_FRAMES * 10000000ull / us / 10,
+		 BENCH_FRAMES * 10000000ull / us % 10);
+
+	free(band);
+}
+/* ########### benchmark ######## */
+#endif
+
 /* ########### standlone ######## */
 static inline void __ram_func ili9488_write_cmd(uint16_t cmd)
 {
@@ -429,6 +940,72 @@ void __ram_func ili9488_flush(lv_disp_drv_t *disp_drv, const lv_area_t *area,
 }
 /* ########### standlone ######## */
 
+static const struct lcd_controller *const lcd_controllers[] = {
+	[LCD_CTRL_ILI9488] = &lcd_ili9488,
+	[LCD_CTRL_ST7796] = &lcd_st7796,
+	[LCD_CTRL_ILI9341] = &lcd_ili9341,
+};
+
+/* by the ID4 readback unless LCD_CONTROLLER names one, the panel is reset */
+static const struct lcd_controller *ili9488_detect(struct ili9488_priv *priv)
+{
+#if LCD_CONTROLLER != LCD_CTRL_AUTO
+	return lcd_controllers[LCD_CONTROLLER];
+#elif DISP_OVER_PIO
+	u32 id = ili9488_read_id();
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(lcd_controllers); i++) {
+		if (lcd_controllers[i] && lcd_controllers[i]->id == id) {
+			pr_debug("found %s\n", lcd_controllers[i]->name);
+			return lcd_controllers[i];
+		}
+	}
+
+	pr_debug("unknown controller, ID4 0x%06x, assuming ili9488\n", id);
+	return &lcd_ili9488;
+#else
+	/* the GPIO bus doesn't read */
+	return &lcd_ili9488;
+#endif
+}
+
+static int ili9488_hw_init(struct ili9488_priv *priv)
+{
+	const struct lcd_controller *ctrl;
+	struct ili9488_display *display = priv->display;
+
+	printf("initializing hardware...\n");
+
+#if DISP_OVER_PIO
+	i80_pio_init(priv->gpio.db[0], ARRAY_SIZE(priv->gpio.db),
+		     priv->gpio.wr, priv->gpio.rd);
+#endif
+	ili9488_gpio_init(priv);
+	ili9488_reset(priv);
+
+	ctrl = ili9488_detect(priv);
+	priv->ctrl = ctrl;
+	if (ctrl->ops)
+		priv->tftops = ctrl->ops;
+
+#if DISP_OVER_PIO
+	/* the autotuner is held to it too */
+	if (ctrl->wr_khz_max)
+		i80_set_bus_clk_max_khz(ctrl->wr_khz_max);
+#endif
+
+	display->xres = display->rotate & 1 ? ctrl->yres : ctrl->xres;
+	display->yres = display->rotate & 1 ? ctrl->xres : ctrl->yres;
+
+	priv->tftops->init_display(priv);
+	priv->tftops->set_dir(priv, display->rotate);
+	/* clear screen to black */
+	// priv->tftops->clear(priv, 0x0);
+
+	return 0;
+}
+
 #define BUF_SIZE 64
 static int ili9488_probe(struct ili9488_priv *priv)
 {
@@ -441,7 +1018,7 @@ static int ili9488_probe(struct ili9488_priv *priv)
 
 	priv->gpio.bl = LCD_PIN_BL;
 	priv->gpio.reset = LCD_PIN_RST;
-	// priv->gpio.rd    = 21;
+	priv->gpio.rd = LCD_PIN_RD;
 	priv->gpio.rs = LCD_PIN_RS;
 	priv->gpio.wr = LCD_PIN_WR;
 	priv->gpio.cs = LCD_PIN_CS;
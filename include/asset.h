@@ -0,0 +1,81 @@
+// Copyright (c) 2026 embeddedboys developers
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef __ASSET_H
+#define __ASSET_H
+
+#include <stdint.h>
+
+#include "lvgl/lvgl.h"
+
+/*
+ * Compressed fonts and images, generated at build time by asset_pack.cmake
+ * with tools/asset_pack.py and decoded by asset.c.
+ *
+ * Glyphs: every pixel is XORed with the one above it, then RLE coded.
+ * 1nnnvvvv repeats v n + 3 times, n == 7 takes the count - 10 from the next
+ * byte. 0nnnnnnn is followed by n + 1 literal pixels, two per byte.
+ *
+ * Images: RGB565 palette, every line is a list of (count - 1, index) runs
+ * starting at line_ofs[y].
+ */
+#define ASSET_IMG_CF LV_IMG_CF_USER_ENCODED_0
+
+#define ASSET_GLYPH_CACHE_SLOTS 16
+#define ASSET_GLYPH_MAX		128 /* bytes, larger glyphs are not drawn */
+
+struct asset_font {
+	uint16_t glyph_cnt;
+	uint16_t max_glyph;
+	uint32_t raw_size;
+	uint32_t packed_size;
+};
+
+struct asset_img {
+	const uint16_t *pal;
+	const uint32_t *line_ofs;
+	const uint8_t *runs;
+	uint16_t pal_cnt;
+	uint32_t raw_size;
+	uint32_t packed_size;
+};
+
+#if ASSET_PACK_ENABLED
+/* generated asset_list.c, NULL terminated */
+extern const lv_font_t *const asset_fonts[];
+extern const char *const asset_font_names[];
+extern const lv_img_dsc_t *const asset_images[];
+extern const char *const asset_image_names[];
+
+extern const uint8_t *asset_font_get_bitmap(const lv_font_t *font,
+					    uint32_t letter);
+extern void asset_init(void);
+extern void asset_benchmark(void);
+#else
+static inline void asset_init(void)
+{
+}
+static inline void asset_benchmark(void)
+{
+}
+#endif
+
+#endif
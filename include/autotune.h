@@ -0,0 +1,50 @@
+// Copyright (c) 2026 embeddedboys developers
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef __AUTOTUNE_H
+#define __AUTOTUNE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+struct clock_profile {
+	uint32_t sys_khz; /* clk_sys and clk_peri */
+	uint32_t bus_khz; /* i80 WR strobe */
+	uint32_t flash_div; /* XIP flash clock = sys_khz / flash_div */
+};
+
+/*
+ * Verifies the i80 bus at the current clocks, e.g. by writing a pattern
+ * to GRAM and reading it back. Without one the bus clock is not tuned.
+ */
+typedef bool (*autotune_check_t)(void);
+
+extern void clock_profile_load(struct clock_profile *prof);
+extern void clock_profile_apply(const struct clock_profile *prof);
+extern void clock_profile_switch(const struct clock_profile *prof);
+extern uint32_t clock_profile_flash_div(uint32_t sys_khz);
+extern void clock_profile_flash_restore(void);
+
+extern void autotune_set_bus_check(autotune_check_t check);
+extern int autotune_run(void);
+extern void autotune_boot(void);
+
+#endif
@@ -23,13 +23,44 @@
 #define __BACKLIGHT_H
 
 #include <stdint.h>
+#include <stdbool.h>
 
 typedef unsigned char u8;
 typedef unsigned short u16;
 
+enum backlight_ease {
+	BL_EASE_LINEAR,
+	BL_EASE_IN_OUT,
+	BL_EASE_OUT,
+};
+
+enum {
+	BL_PROFILE_NORMAL,
+	BL_PROFILE_NIGHT,
+	BL_PROFILE_OUTDOOR,
+};
+
 void backlight_driver_init(void);
 void backlight_set_level(u8 level);
 u8 backlight_get_level(void);
+void backlight_set_power(bool on);
+
+/*
+ * Fade to a level in the background, the DMA writes the PWM compare values.
+ * A new fade or backlight_set_level() takes over from wherever a running fade
+ * is. duration_ms 0 sets the level at once.
+ */
+void backlight_fade_to(u8 level, u16 duration_ms, enum backlight_ease ease);
+bool backlight_fade_busy(void);
+int backlight_set_profile(u8 id);
+
+void backlight_set_pwm_freq(uint32_t hz);
+uint32_t backlight_get_pwm_freq(void);
+void backlight_update_clk(void);
+
+void backlight_set_gain(u16 gain, u16 duration_ms);
+u16 backlight_get_gain(void);
+uint32_t backlight_get_duty(bool gained);
 
 u8 backlight_get_offset(void);
 void backlight_set_offset(u8 offset);
@@ -0,0 +1,62 @@
+// Copyright (c) 2026 embeddedboys developers
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef __CABC_H
+#define __CABC_H
+
+#include <stdint.h>
+
+/*
+ * Content adaptive backlight. The flush path feeds the pixels it sends to
+ * cabc_sample(), a sparse luma histogram is built per frame and a dark frame
+ * turns the backlight down by up to CABC_MIN_GAIN / 256 of perceived
+ * brightness, through backlight_set_gain(). There is no pixel compensation,
+ * dark scenes simply get darker, by an amount the eye adapts to.
+ *
+ * CABC_PANEL_MODE writes the ILI9488's own CABC registers, which drive its
+ * LEDPWM pin. This module dims its LEDs from LCD_PIN_BL instead, so it only
+ * matters on boards where that pin is wired up.
+ */
+#define CABC_MIN_GAIN 160
+#define CABC_FADE_MS  500
+
+#if CABC_ENABLED
+extern void cabc_sample(const void *px, int w, int h, int stride);
+extern void cabc_frame_end(void);
+extern void cabc_set_frame_size(int w, int h);
+extern void cabc_init(void);
+#else
+static inline void cabc_sample(const void *px, int w, int h, int stride)
+{
+}
+static inline void cabc_frame_end(void)
+{
+}
+static inline void cabc_set_frame_size(int w, int h)
+{
+}
+static inline void cabc_init(void)
+{
+}
+#endif
+
+#endif
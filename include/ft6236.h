@@ -28,6 +28,7 @@
 #define FT6236_PIN_SCL 27
 #define FT6236_PIN_SDA 26
 #define FT6236_PIN_RST 18
+#define FT6236_PIN_INT -1 /* -1: INT not wired, the touch is polled */
 
 #define CT_MAX_TOUCH 5
 
@@ -42,8 +43,11 @@
 #define FT_REG_TOUCH1_YH 0x05 // Touch point 1 Y high 8-bit
 #define FT_REG_TOUCH1_YL 0x06 // Touch point 1 Y low 8-bit
 
-#define FT_REG_TH_GROUP	    0x80
-#define FT_REG_PERIODACTIVE 0x88
+#define FT_REG_TH_GROUP		 0x80
+#define FT_REG_CTRL		 0x86 // 0: stay active, 1: monitor mode when idle
+#define FT_REG_TIMEENTERMONITOR	 0x87 // idle seconds before monitor mode
+#define FT_REG_PERIODACTIVE	 0x88 // report rate when active, 10 Hz units
+#define FT_REG_PERIODMONITOR	 0x89 // report rate in monitor mode
 
 #define FT_REG_LIB_VER_H       0xA1
 #define FT_REG_LIB_VER_L       0xA2
@@ -53,10 +57,30 @@
 #define FT_REG_RELEASE_CODE_ID 0xAF
 #define FT_REG_STATE	       0xBC
 
+/*
+ * Affine transform of touch coordinates, 16.16 fixed point:
+ *   x' = (xx * x + xy * y + x0) >> 16
+ *   y' = (yx * x + yy * y + y0) >> 16
+ */
+#define TOUCH_MATRIX_SHIFT 16
+
+struct touch_matrix {
+	int32_t xx, xy, x0;
+	int32_t yx, yy, y0;
+};
+
 extern int ft6236_driver_init(void);
 extern bool ft6236_is_pressed(void);
 extern void ft6236_set_dir(uint8_t dir);
 extern uint16_t ft6236_read_x(void);
 extern uint16_t ft6236_read_y(void);
+extern void ft6236_read_xy(uint16_t *x, uint16_t *y);
+extern bool ft6236_poll(uint16_t *x, uint16_t *y, uint32_t *t_us);
+extern void ft6236_poll_start(void);
+extern void ft6236_set_report_rate(unsigned int hz);
+extern void ft6236_read_raw(uint16_t *x, uint16_t *y);
+extern void ft6236_set_calibration(const struct touch_matrix *m);
+extern const struct touch_matrix *ft6236_get_rotation_matrix(void);
+extern void ft6236_update_clk(void);
 
 #endif
@@ -0,0 +1,64 @@
+// Copyright (c) 2026 embeddedboys developers
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef __GLYPH_CACHE_H
+#define __GLYPH_CACHE_H
+
+#include <stdint.h>
+
+#include "lvgl/lvgl.h"
+
+/*
+ * Cache of rendered glyphs in front of the software letter renderer.
+ *
+ * Glyphs drawn over a uniform background are kept pre-blended in lv_color_t,
+ * keyed by font, letter, colour and background, and are copied straight
+ * into the draw buffer. Other glyphs are kept as A8 masks so at least the
+ * bitmap decoding and bpp expansion are skipped.
+ *
+ * GLYPH_CACHE_SIZE (CMakeLists.txt) bytes of SRAM are split into slots of
+ * GLYPH_CACHE_SLOT bytes, least recently used slots are reused first.
+ */
+#define GLYPH_CACHE_SLOT 384 /* 192 px RGB565 or 384 px RGB332/A8 */
+
+struct glyph_cache_stats {
+	uint32_t a8_hit;
+	uint32_t a8_miss;
+	uint32_t rgb_hit;
+	uint32_t rgb_miss;
+	uint32_t evict;
+	uint32_t bypass; /* clipped by masks, too large, not opaque... */
+};
+
+#if GLYPH_CACHE_SIZE
+extern void glyph_cache_init(lv_disp_t *disp);
+extern void glyph_cache_get_stats(struct glyph_cache_stats *stats);
+extern void glyph_cache_report(void);
+#else
+static inline void glyph_cache_init(lv_disp_t *disp)
+{
+}
+static inline void glyph_cache_report(void)
+{
+}
+#endif
+
+#endif
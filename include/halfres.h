@@ -0,0 +1,59 @@
+// Copyright (c) 2026 embeddedboys developers
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+
+#ifndef __HALFRES_H
+#define __HALFRES_H
+
+#include <stdbool.h>
+
+#include "lvgl/lvgl.h"
+
+/*
+ * Half resolution rendering for animation heavy screens. LVGL renders at
+ * half the panel resolution, a quarter of the pixels, and the flush path
+ * doubles them on the way out: the PIO strobes every pixel twice and the DMA
+ * sends every line twice, see i80_write_buf_x2_async().
+ *
+ * halfres_screen() marks a screen, the display switches when it starts to
+ * load. Mark both sides, an unmarked screen keeps the current mode. Load
+ * animations between screens of different modes are not supported.
+ * Touch coordinates are scaled to match.
+ */
+#if HALFRES_ENABLED
+extern void halfres_set(lv_disp_t *disp, bool on);
+extern bool halfres_get(void);
+extern void halfres_screen(lv_obj_t *scr, bool on);
+#else
+static inline void halfres_set(lv_disp_t *disp, bool on)
+{
+}
+static inline bool halfres_get(void)
+{
+	return false;
+}
+static inline void halfres_screen(lv_obj_t *scr, bool on)
+{
+}
+#endif
+
+#endif
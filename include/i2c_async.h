@@ -0,0 +1,66 @@
+// Copyright (c) 2026 embeddedboys developers
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef __I2C_ASYNC_H
+#define __I2C_ASYNC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "hardware/i2c.h"
+
+/*
+ * Queued I2C transactions fed by DMA.
+ *
+ * A transaction writes tx_len bytes then, after a repeated start, reads
+ * rx_len bytes and ends with a stop. Transactions on one bus run in
+ * submission order; the completion callback runs in the I2C interrupt,
+ * where it may submit the next one. Everyone on a bus has to go through
+ * here, a blocking SDK call would collide with a queued transaction.
+ */
+#define I2C_ASYNC_MAX_LEN 32 /* tx_len + rx_len */
+#define I2C_ASYNC_PENDING 1 /* status until done, then PICO_OK or < 0 */
+
+struct i2c_xfer;
+typedef void (*i2c_xfer_cb_t)(struct i2c_xfer *xfer);
+
+struct i2c_xfer {
+	uint8_t addr;
+	uint8_t tx_len;
+	uint8_t rx_len;
+	const uint8_t *tx;
+	uint8_t *rx;
+	i2c_xfer_cb_t cb; /* may be NULL, interrupt context */
+	void *priv;
+
+	volatile int status;
+	struct i2c_xfer *next;
+};
+
+extern int i2c_async_init(i2c_inst_t *i2c);
+extern int i2c_async_submit(i2c_inst_t *i2c, struct i2c_xfer *xfer);
+extern void i2c_async_wait_idle(i2c_inst_t *i2c);
+extern int i2c_async_write_read(i2c_inst_t *i2c, uint8_t addr,
+				const uint8_t *tx, size_t tx_len, uint8_t *rx,
+				size_t rx_len);
+
+#endif
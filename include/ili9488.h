@@ -25,9 +25,14 @@
 #include <stdint.h>
 #include "lvgl/lvgl.h"
 
+/* boot time resolution, see ili9488_set_rotation() */
 #define ILI9488_X_RES LCD_HOR_RES
 #define ILI9488_Y_RES LCD_VER_RES
 
+/* the panel in LCD_ROTATE_0 */
+#define ILI9488_NATIVE_X_RES 320
+#define ILI9488_NATIVE_Y_RES 480
+
 enum { LCD_ROTATE_0, LCD_ROTATE_90, LCD_ROTATE_180, LCD_ROTATE_270 };
 #define BIT(nr) (1UL << (nr))
 #define MADCTL	0x36
@@ -42,6 +47,31 @@ enum { LCD_ROTATE_0, LCD_ROTATE_90, LCD_ROTATE_180, LCD_ROTATE_270 };
 extern int ili9488_driver_init();
 extern void ili9488_video_flush(int xs, int ys, int xe, int ye, void *vmem16,
 				uint32_t len);
+extern void ili9488_video_flush_async(int xs, int ys, int xe, int ye,
+				      void *vmem16, uint32_t len);
+extern void ili9488_video_flush_x2_async(int xs, int ys, int xe, int ye,
+					void *vmem16, uint32_t stride);
+extern void ili9488_video_flush_clut(int xs, int ys, int xe, int ye,
+				     void *vmem8, uint32_t stride);
+extern void ili9488_set_clut(const uint16_t *clut);
+extern void ili9488_video_flush_wait(void);
+extern void ili9488_video_flush_area(int xs, int ys, int xe, int ye,
+				     void *vmem16, uint32_t stride);
+extern void ili9488_video_batch_add(int xs, int ys, int xe, int ye,
+				    void *vmem16, uint32_t stride);
+extern void ili9488_video_batch_kick(void);
+extern void ili9488_set_rotation(uint8_t rotate);
+extern uint8_t ili9488_get_rotation(void);
+extern uint32_t ili9488_get_xres(void);
+extern uint32_t ili9488_get_yres(void);
+extern uint32_t ili9488_get_native_xres(void);
+extern uint32_t ili9488_get_native_yres(void);
+extern void ili9488_set_blank(bool blank);
+extern void ili9488_set_sleep(bool sleep);
+extern uint32_t ili9488_read_id(void);
+extern int ili9488_read_gram(int xs, int ys, int xe, int ye, uint16_t *buf);
+extern bool ili9488_bus_check(void);
+extern void ili9488_bus_benchmark(void);
 extern void ili9488_flush(lv_disp_drv_t *disp_drv, const lv_area_t *area,
 			  lv_color_t *color_p);
 #endif
@@ -0,0 +1,77 @@
+// Copyright (c) 2026 embeddedboys developers
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef __LCD_PANEL_H
+#define __LCD_PANEL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * The 8080 controllers the driver knows. They all speak MIPI DCS for
+ * windowing, memory writes, MADCTL and sleep, so the ili9488_operations in
+ * ili9488.c serve them all unless a controller brings its own. What differs
+ * is described here and the one on the bus is picked by its ID4 (0xD3)
+ * readback, see LCD_CONTROLLER in CMakeLists.txt.
+ */
+enum {
+	LCD_CTRL_AUTO,
+	LCD_CTRL_ILI9488,
+	LCD_CTRL_ST7796,
+	LCD_CTRL_ILI9341,
+};
+
+/* pixel formats, as COLMOD bits and as capability masks */
+#define LCD_PIXFMT_RGB565 (1u << 0)
+#define LCD_PIXFMT_RGB666 (1u << 1)
+#define LCD_PIXFMT_RGB888 (1u << 2)
+
+#define LCD_COLMOD_RGB565 0x55
+#define LCD_COLMOD_RGB666 0x66
+#define LCD_COLMOD_RGB888 0x77
+
+struct ili9488_operations;
+
+struct lcd_controller {
+	const char *name;
+	uint8_t type; /* LCD_CTRL_* */
+	uint32_t id; /* ID4, the 3 low bytes of the 0xD3 readback */
+
+	/* LCD_ROTATE_0 */
+	uint16_t xres;
+	uint16_t yres;
+
+	const uint8_t *madctl; /* one per LCD_ROTATE_* */
+	const uint32_t *init_seq; /* lcd_seq.h, without COLMOD */
+	size_t init_len;
+
+	uint8_t pixfmts; /* LCD_PIXFMT_* it can take */
+	uint32_t wr_khz_max; /* write cycle limit, 0: as fast as the bus goes */
+
+	const struct ili9488_operations *ops; /* NULL: the DCS ones */
+};
+
+extern const struct lcd_controller lcd_ili9488;
+extern const struct lcd_controller lcd_st7796;
+extern const struct lcd_controller lcd_ili9341;
+
+#endif
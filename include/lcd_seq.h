@@ -0,0 +1,103 @@
+// Copyright (c) 2026 embeddedboys developers
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef __LCD_SEQ_H
+#define __LCD_SEQ_H
+
+#include <stdint.h>
+
+/*
+ * Panel command streams, built at compile time from tables like
+ *
+ *	static const uint32_t init_seq[] = {
+ *		LCD_SEQ_REG(0xC0, 0x17, 0x15),
+ *		LCD_SEQ_CMD(0x11),
+ *		LCD_SEQ_DELAY_MS(60),
+ *		LCD_SEQ_CMD(0x29),
+ *	};
+ *
+ * Every word is either a bus write with its RS level, a delay or the start
+ * of a pixel run, so a whole sequence goes out in one DMA transfer on the
+ * PIO bus, see i80_stream in pio/i80.pio. The bit layout is what the state
+ * machine shifts out, LSB first:
+ *
+ *	bit 0      1: delay, bits 31..1 are microseconds
+ *	bit 1      1: pixel run, bits 31..2 are the number of pixels - 1,
+ *	           the RGB565 pixels follow two per word, low half first
+ *	bit 2      RS, 0: command, 1: parameter
+ *	bit 18..3  bus value
+ */
+#define LCD_SEQ_DELAY_FLAG 1u
+#define LCD_SEQ_RUN_FLAG   2u
+#define LCD_SEQ_RS_FLAG	   4u
+
+#define LCD_SEQ_CMD(c)	      ((uint32_t)(c) << 3)
+#define LCD_SEQ_DAT(d)	      ((uint32_t)(d) << 3 | LCD_SEQ_RS_FLAG)
+#define LCD_SEQ_DELAY_US(us)  ((uint32_t)(us) << 1 | LCD_SEQ_DELAY_FLAG)
+#define LCD_SEQ_DELAY_MS(ms)  LCD_SEQ_DELAY_US((ms) * 1000u)
+#define LCD_SEQ_RUN(n)	      ((uint32_t)((n) - 1) << 2 | LCD_SEQ_RUN_FLAG)
+
+#define LCD_SEQ_IS_DELAY(w)   ((w) & LCD_SEQ_DELAY_FLAG)
+#define LCD_SEQ_US(w)	      ((w) >> 1)
+#define LCD_SEQ_RS(w)	      (!!((w) & LCD_SEQ_RS_FLAG))
+#define LCD_SEQ_VAL(w)	      ((uint16_t)((w) >> 3))
+
+/*
+ * A stream split over memory, e.g. window commands and the framebuffer
+ * lines they cover. A list of blocks goes out in one go through a second
+ * DMA channel, {0, NULL} ends it.
+ */
+struct lcd_seq_blk {
+	/* the order of al3_transfer_count and al3_read_addr_trig */
+	uint32_t count; /* words */
+	const void *read;
+};
+
+/* a command followed by 1 to 15 parameters */
+#define LCD_SEQ_REG(c, ...) \
+	LCD_SEQ_CMD(c), __LCD_SEQ_CAT(__LCD_SEQ_D, __LCD_SEQ_NARGS(__VA_ARGS__))(__VA_ARGS__)
+
+#define __LCD_SEQ_CAT(a, b)  __LCD_SEQ_CAT_(a, b)
+#define __LCD_SEQ_CAT_(a, b) a##b
+#define __LCD_SEQ_NARGS(...) \
+	__LCD_SEQ_NARGS_(__VA_ARGS__, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define __LCD_SEQ_NARGS_(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, \
+			 _13, _14, _15, n, ...)                              \
+	n
+
+#define __LCD_SEQ_D1(d)	      LCD_SEQ_DAT(d)
+#define __LCD_SEQ_D2(d, ...)  LCD_SEQ_DAT(d), __LCD_SEQ_D1(__VA_ARGS__)
+#define __LCD_SEQ_D3(d, ...)  LCD_SEQ_DAT(d), __LCD_SEQ_D2(__VA_ARGS__)
+#define __LCD_SEQ_D4(d, ...)  LCD_SEQ_DAT(d), __LCD_SEQ_D3(__VA_ARGS__)
+#define __LCD_SEQ_D5(d, ...)  LCD_SEQ_DAT(d), __LCD_SEQ_D4(__VA_ARGS__)
+#define __LCD_SEQ_D6(d, ...)  LCD_SEQ_DAT(d), __LCD_SEQ_D5(__VA_ARGS__)
+#define __LCD_SEQ_D7(d, ...)  LCD_SEQ_DAT(d), __LCD_SEQ_D6(__VA_ARGS__)
+#define __LCD_SEQ_D8(d, ...)  LCD_SEQ_DAT(d), __LCD_SEQ_D7(__VA_ARGS__)
+#define __LCD_SEQ_D9(d, ...)  LCD_SEQ_DAT(d), __LCD_SEQ_D8(__VA_ARGS__)
+#define __LCD_SEQ_D10(d, ...) LCD_SEQ_DAT(d), __LCD_SEQ_D9(__VA_ARGS__)
+#define __LCD_SEQ_D11(d, ...) LCD_SEQ_DAT(d), __LCD_SEQ_D10(__VA_ARGS__)
+#define __LCD_SEQ_D12(d, ...) LCD_SEQ_DAT(d), __LCD_SEQ_D11(__VA_ARGS__)
+#define __LCD_SEQ_D13(d, ...) LCD_SEQ_DAT(d), __LCD_SEQ_D12(__VA_ARGS__)
+#define __LCD_SEQ_D14(d, ...) LCD_SEQ_DAT(d), __LCD_SEQ_D13(__VA_ARGS__)
+#define __LCD_SEQ_D15(d, ...) LCD_SEQ_DAT(d), __LCD_SEQ_D14(__VA_ARGS__)
+
+#endif
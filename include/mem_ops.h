@@ -0,0 +1,46 @@
+// Copyright (c) 2026 embeddedboys developers
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef __MEM_OPS_H
+#define __MEM_OPS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Copies and fills shorter than these (in bytes) are done by the CPU with
+ * unrolled word loops, larger ones are handed to a spare DMA channel.
+ * Tune them with mem_ops_benchmark().
+ */
+#ifndef MEM_OPS_DMA_MEMCPY_MIN
+#define MEM_OPS_DMA_MEMCPY_MIN 256
+#endif
+
+#ifndef MEM_OPS_DMA_MEMSET_MIN
+#define MEM_OPS_DMA_MEMSET_MIN 128
+#endif
+
+extern int mem_ops_init(void);
+extern void *mem_ops_memcpy(void *dst, const void *src, size_t len);
+extern void *mem_ops_memset(void *dst, int c, size_t len);
+extern void mem_ops_benchmark(void);
+
+#endif
@@ -0,0 +1,80 @@
+// Copyright (c) 2026 embeddedboys developers
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef __PERF_H
+#define __PERF_H
+
+#include <stdint.h>
+
+#include "pico/time.h"
+#include "hardware/structs/xip_ctrl.h"
+
+/*
+ * Tracing spans, each one accumulates the time spent in it and the XIP
+ * cache hits/accesses that happened meanwhile.
+ */
+enum perf_span_id {
+	PERF_SPAN_FRAME, /* one LVGL refresh cycle, render + flush */
+	PERF_SPAN_FLUSH,
+	PERF_SPAN_TOUCH,
+	PERF_SPAN_CABC, /* luma histogram of the flushed pixels */
+	PERF_SPAN_MAX,
+};
+
+#if PERF_STATS_ENABLED
+struct perf_mark {
+	uint32_t us;
+	uint32_t hit;
+	uint32_t acc;
+};
+
+static inline void perf_mark(struct perf_mark *m)
+{
+	m->us = time_us_32();
+	m->hit = xip_ctrl_hw->ctr_hit;
+	m->acc = xip_ctrl_hw->ctr_acc;
+}
+
+#define PERF_SPAN_BEGIN(m) \
+	struct perf_mark m;    \
+	perf_mark(&m)
+#define PERF_SPAN_END(id, m) perf_span_add(id, &m)
+
+extern void perf_span_add(enum perf_span_id id, const struct perf_mark *begin);
+extern void perf_frame_begin(void);
+extern void perf_frame_end(uint32_t px);
+extern void perf_init(void);
+#else
+#define PERF_SPAN_BEGIN(m)
+#define PERF_SPAN_END(id, m)
+
+static inline void perf_frame_begin(void)
+{
+}
+static inline void perf_frame_end(uint32_t px)
+{
+}
+static inline void perf_init(void)
+{
+}
+#endif
+
+#endif
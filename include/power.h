@@ -0,0 +1,65 @@
+// Copyright (c) 2026 embeddedboys developers
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef __POWER_H
+#define __POWER_H
+
+#include <stdint.h>
+
+/*
+ * Idle power management driven by lv_disp_get_inactive_time():
+ *
+ *   PM_DIM_MS    the backlight goes down to PM_DIM_LEVEL
+ *   PM_SLEEP_MS  backlight off, panel display-off and sleep-in, clk_sys
+ *                down to PM_SLEEP_SYS_KHZ, the core sleeps until a touch
+ *
+ * The touch that wakes the screen is swallowed. From the touch being seen
+ * to the panel showing the image again should take less than
+ * PM_WAKE_BUDGET_US, power_benchmark() measures it.
+ */
+#define PM_DIM_MS	  30000
+#define PM_SLEEP_MS	  120000
+#define PM_DIM_LEVEL	  10
+#define PM_DIM_FADE_MS	  1000
+#define PM_WAKE_FADE_MS	  150
+#define PM_SLEEP_SYS_KHZ  48000
+#define PM_SLEEP_POLL_MS  50 /* touch polling while asleep without INT */
+#define PM_WAKE_BUDGET_US 20000
+
+/* from the touch being seen, in us */
+struct power_wake_stats {
+	uint32_t clk_us; /* clk_sys back up */
+	uint32_t panel_us; /* sleep-out, display-on, backlight */
+	uint32_t frame_us; /* pending LVGL refresh flushed */
+};
+
+#if POWER_MGR_ENABLED
+extern void power_init(void);
+extern void power_sleep(void);
+extern void power_benchmark(void);
+#else
+static inline void power_init(void)
+{
+}
+#endif
+
+#endif
@@ -0,0 +1,66 @@
+// Copyright (c) 2026 embeddedboys developers
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef __RFB_H
+#define __RFB_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Remote framebuffer sink, the panel is driven by a host over USB CDC and
+ * LVGL is not started at all. tools/rfb_send.py is the sender.
+ *
+ * Each packet is a struct rfb_hdr followed by `len` bytes of payload. A
+ * rectangle decodes to at most RFB_BUF_PX pixels, the sender splits larger
+ * ones into bands. Multi-byte fields are little endian.
+ */
+#define RFB_MAGIC0 'R'
+#define RFB_MAGIC1 'F'
+
+#define RFB_BUF_PX   4096 /* decoded pixels per rectangle */
+#define RFB_RX_SIZE  (RFB_BUF_PX * 2) /* largest payload, raw is no bigger */
+
+enum rfb_packet_type {
+	RFB_RECT_RAW = 1, /* RGB565 pixels */
+	RFB_RECT_RLE, /* runs of (count - 1, RGB565 lo, RGB565 hi) */
+	RFB_RECT_LZ4, /* LZ4 block of the RGB565 pixels */
+	RFB_SYNC, /* echoed once all is on the panel, len = dropped packets */
+};
+
+struct rfb_hdr {
+	uint8_t magic[2];
+	uint8_t type;
+	uint8_t seq;
+	uint16_t x;
+	uint16_t y;
+	uint16_t w;
+	uint16_t h;
+	uint16_t len;
+} __attribute__((packed));
+
+extern void rfb_sink_run(void);
+extern int rfb_decode_rle(const uint8_t *src, size_t len, uint16_t *dst,
+			  size_t count);
+extern int rfb_decode_lz4(const uint8_t *src, size_t len, uint16_t *dst,
+			  size_t count);
+
+#endif
@@ -0,0 +1,39 @@
+// Copyright (c) 2026 embeddedboys developers
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef __ROTATION_H
+#define __ROTATION_H
+
+#include <stdint.h>
+
+#include "lvgl/lvgl.h"
+
+/*
+ * Rotate the whole display at runtime, LCD_ROTATION (CMakeLists.txt) is
+ * only the one we boot with. The panel scan direction, the touch mapping
+ * and the LVGL resolution are changed together, then the screen is
+ * invalidated and redrawn on the next refresh. Takes LCD_ROTATE_*.
+ */
+extern void rotation_set(lv_disp_t *disp, uint8_t rotate);
+extern uint8_t rotation_get(void);
+
+#endif
@@ -0,0 +1,59 @@
+// Copyright (c) 2026 embeddedboys developers
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef __SCREENCAP_H
+#define __SCREENCAP_H
+
+#include <stdint.h>
+
+/*
+ * Screen capture over USB CDC, tools/screencap.py on the host side.
+ *
+ * Every packet starts with SCAP_MAGIC0, SCAP_MAGIC1, type and payload length,
+ * everything in between is ordinary stdio text. Multi-byte fields are little
+ * endian. Tile payloads are RLE runs of (count - 1, RGB565 lo, RGB565 hi).
+ */
+#define SCAP_MAGIC0 0xA5
+#define SCAP_MAGIC1 0x5C
+
+enum scap_packet_type {
+	SCAP_FRAME_BEGIN = 1, /* u16 frame, u16 width, u16 height, u8 delta */
+	SCAP_TILE_DATA, /* u16 x, u16 y, u8 w, u8 h, u16 pixel offset, runs */
+	SCAP_FRAME_END, /* u16 frame */
+};
+
+/* host commands, read from stdin */
+#define SCAP_CMD_SHOT	's' /* capture one full frame */
+#define SCAP_CMD_STREAM 'S' /* toggle streaming changed tiles only */
+
+#if SCREENCAP_ENABLED
+extern void screencap_init(void);
+extern void screencap_mark_dirty(int xs, int ys, int xe, int ye);
+#else
+static inline void screencap_init(void)
+{
+}
+static inline void screencap_mark_dirty(int xs, int ys, int xe, int ye)
+{
+}
+#endif
+
+#endif
@@ -0,0 +1,57 @@
+// Copyright (c) 2026 embeddedboys developers
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef __TOUCH_CALIB_H
+#define __TOUCH_CALIB_H
+
+#include <stdbool.h>
+
+/*
+ * Touch calibration. A 3 or 5 point (TOUCH_CALIB_POINTS) screen collects
+ * raw controller coordinates for crosshairs at known positions and fits
+ * the affine matrix ft6236_read_xy() applies, by least squares when there
+ * are more points than unknowns. The matrix is kept in native panel
+ * coordinates, so it stays valid across rotation_set(), and persisted in
+ * flash next to the clock profile.
+ */
+typedef void (*touch_calib_done_t)(bool ok);
+
+#if TOUCH_CALIB_POINTS
+extern bool touch_calib_init(void);
+extern void touch_calib_start(touch_calib_done_t done);
+extern void touch_calib_reset(void);
+#else
+static inline bool touch_calib_init(void)
+{
+	return false;
+}
+static inline void touch_calib_start(touch_calib_done_t done)
+{
+	if (done)
+		done(false);
+}
+static inline void touch_calib_reset(void)
+{
+}
+#endif
+
+#endif
@@ -0,0 +1,62 @@
+// Copyright (c) 2026 embeddedboys developers
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef __TOUCH_FILTER_H
+#define __TOUCH_FILTER_H
+
+#include <stdint.h>
+
+/*
+ * Touch smoothing and prediction between the FT6236 and LVGL.
+ *
+ * Each axis goes through a One-Euro filter: a low pass whose cutoff rises
+ * with the speed, so a resting finger does not jitter and a moving one
+ * does not lag much. The filtered speed is then used to extrapolate
+ * predict_ms ahead, hiding part of the read period and the frame the
+ * flush pipeline adds. tools/touch_replay.c runs this file on the host
+ * against recorded or synthetic traces.
+ */
+struct touch_filter_params {
+	float min_cutoff; /* Hz, at rest, lower is steadier */
+	float beta; /* cutoff increase per px/s, higher lags less */
+	float d_cutoff; /* Hz, of the speed estimate */
+	float predict_ms; /* extrapolation, 0: none */
+	float predict_max; /* px, cap of the extrapolation per axis */
+};
+
+#define TOUCH_FILTER_DEFAULTS { 1.0f, 0.05f, 8.0f, TOUCH_PREDICT_MS, 48.0f }
+
+#if TOUCH_FILTER_ENABLED
+extern void touch_filter_set_params(const struct touch_filter_params *p);
+extern void touch_filter_get_params(struct touch_filter_params *p);
+extern void touch_filter_update(int16_t *x, int16_t *y, uint32_t t_us);
+extern void touch_filter_reset(uint32_t t_us);
+#else
+static inline void touch_filter_update(int16_t *x, int16_t *y, uint32_t t_us)
+{
+}
+static inline void touch_filter_reset(uint32_t t_us)
+{
+}
+#endif
+
+#endif
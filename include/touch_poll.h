@@ -0,0 +1,59 @@
+// Copyright (c) 2026 embeddedboys developers
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef __TOUCH_POLL_H
+#define __TOUCH_POLL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "lvgl/lvgl.h"
+
+#include "ft6236.h"
+
+/*
+ * Adaptive touch polling. The LVGL read timer runs every
+ * TOUCH_POLL_FAST_MS while touched and for TOUCH_POLL_HOLD_MS after,
+ * then its period doubles on every idle read up to TOUCH_POLL_SLOW_MS.
+ * The background I2C read is started TOUCH_POLL_LEAD_US before the next
+ * LVGL read, so the sample it gets is fresh.
+ */
+#define TOUCH_POLL_FAST_MS 8
+#define TOUCH_POLL_SLOW_MS 64
+#define TOUCH_POLL_HOLD_MS 500 /* taps come in pairs */
+#define TOUCH_POLL_LEAD_US 1000 /* a 5 byte read takes ~200 us at 400 kHz */
+
+#if TOUCH_POLL_ADAPTIVE
+extern void touch_poll_init(lv_indev_t *indev);
+extern void touch_poll_update(bool pressed, uint32_t t_us);
+#else
+static inline void touch_poll_init(lv_indev_t *indev)
+{
+}
+/* read for the next LVGL read right away, it is one period old by then */
+static inline void touch_poll_update(bool pressed, uint32_t t_us)
+{
+	ft6236_poll_start();
+}
+#endif
+
+#endif
@@ -23,8 +23,13 @@
    COLOR SETTINGS
  *====================*/
 
-/*Color depth: 1 (1 byte per pixel), 8 (RGB332), 16 (RGB565), 32 (ARGB8888)*/
+/*Color depth: 1 (1 byte per pixel), 8 (RGB332), 16 (RGB565), 32 (ARGB8888)
+ *DISP_COLOR_INDEXED (CMakeLists.txt) renders RGB332, the flush expands it through a colour table*/
+#if DISP_COLOR_INDEXED
+#define LV_COLOR_DEPTH 8
+#else
 #define LV_COLOR_DEPTH 16
+#endif
 
 /*Swap the 2 bytes of RGB565 color. Useful if the display has an 8-bit interface (e.g. SPI)*/
 #define LV_COLOR_16_SWAP 0
@@ -70,8 +75,9 @@
  *You will see an error log message if there wasn't enough buffers. */
 #define LV_MEM_BUF_MAX_NUM 16
 
-/*Use the standard `memcpy` and `memset` instead of LVGL's own functions. (Might or might not be faster).*/
-#define LV_MEMCPY_MEMSET_STD 0
+/*Use the standard `memcpy` and `memset` instead of LVGL's own functions. (Might or might not be faster).
+ *With MEM_OPS_USE_DMA (CMakeLists.txt) they are redirected to the DMA assisted ones in mem_ops.c*/
+#define LV_MEMCPY_MEMSET_STD 1
 
 /*====================
    HAL SETTINGS
@@ -39,6 +39,20 @@
 #include "ili9488.h"
 #include "ft6236.h"
 #include "backlight.h"
+#include "mem_ops.h"
+#include "perf.h"
+#include "autotune.h"
+#include "screencap.h"
+#include "rfb.h"
+#include "asset.h"
+#include "glyph_cache.h"
+#include "rotation.h"
+#include "touch_calib.h"
+#include "touch_filter.h"
+#include "touch_poll.h"
+#include "power.h"
+#include "cabc.h"
+#include "halfres.h"
 
 #include "lvgl/lvgl.h"
 #include "lvgl/demos/lv_demos.h"
@@ -49,68 +63,260 @@
  *
  * NOTE: Avoid race conditions between two
  * cores accessing XIP as much as possible.
+ * SRAM_HOT_PATH in CMakeLists.txt moves the
+ * LVGL renderer out of XIP.
  */
 #define LVGL_USE_CORE1 0
 
+/*
+ * LVGL render mode, set by DISP_RENDER_MODE in CMakeLists.txt.
+ *
+ * In direct_mode and full_refresh mode the draw buffer is a persistent
+ * full-screen framebuffer, only the invalidated areas are sent to the panel.
+ */
+#define DISP_RENDER_PARTIAL	 0
+#define DISP_RENDER_DIRECT	 1
+#define DISP_RENDER_FULL_REFRESH 2
+
+#ifndef DISP_RENDER_MODE
+#define DISP_RENDER_MODE DISP_RENDER_PARTIAL
+#endif
+
 #ifndef MY_DISP_BUF_SIZE
 #warning '"MY_DISP_BUF_SIZE" is not defined, defaulting to (HOR_RES * VER_RES / 2)'
 #define MY_DISP_BUF_SIZE (MY_DISP_HOR_RES * MY_DISP_VER_RES / 2)
 #endif
 
+/*Boot to the first pixels on the panel, the timer starts at reset*/
+static void report_first_pixel(void)
+{
+	static bool reported;
+
+	if (reported)
+		return;
+
+	reported = true;
+	printf("first pixel %llu us after boot\n", time_us_64());
+}
+
+#if HALFRES_ENABLED
+/*Half resolution areas land on the panel as 2x2 pixel blocks*/
+static void __attribute__((section(".time_critical.lvgl")))
+my_flush_x2(const lv_area_t *area, lv_color_t *px, int stride)
+{
+	screencap_mark_dirty(area->x1 * 2, area->y1 * 2, area->x2 * 2 + 1,
+			     area->y2 * 2 + 1);
+	ili9488_video_flush_x2_async(area->x1, area->y1, area->x2, area->y2,
+				     (void *)px, stride);
+}
+#else
+static inline void my_flush_x2(const lv_area_t *area, lv_color_t *px,
+			       int stride)
+{
+}
+#endif
+
+#if DISP_COLOR_INDEXED
+/*LVGL renders RGB332, the flush DMA looks every pixel up in this table*/
+static void my_clut_init(void)
+{
+	uint16_t clut[256];
+	int i, r, g, b;
+
+	for (i = 0; i < 256; i++) {
+		r = i >> 5;
+		g = (i >> 2) & 7;
+		b = i & 3;
+		clut[i] = (r << 2 | r >> 1) << 11 | (g << 3 | g) << 5 |
+			  (b << 3 | b << 1 | b >> 1);
+	}
+	ili9488_set_clut(clut);
+}
+
+static void __attribute__((section(".time_critical.lvgl")))
+my_flush_clut(const lv_area_t *area, lv_color_t *px, int stride)
+{
+	screencap_mark_dirty(area->x1, area->y1, area->x2, area->y2);
+	ili9488_video_flush_clut(area->x1, area->y1, area->x2, area->y2,
+				 (void *)px, stride);
+}
+#else
+static inline void my_clut_init(void)
+{
+}
+static inline void my_flush_clut(const lv_area_t *area, lv_color_t *px,
+				 int stride)
+{
+}
+#endif
+
 static void __attribute__((section(".time_critical.lvgl")))
 my_flush_cb(lv_disp_drv_t *disp_drv, const lv_area_t *area, lv_color_t *color_p)
 {
-	ili9488_video_flush(area->x1, area->y1, area->x2, area->y2,
-			    (void *)color_p,
-			    lv_area_get_size(area) * sizeof(lv_color_t));
+	PERF_SPAN_BEGIN(flush);
+
+	if (DISP_COLOR_INDEXED) {
+		my_flush_clut(area, color_p, lv_area_get_width(area));
+	} else if (halfres_get()) {
+		my_flush_x2(area, color_p, lv_area_get_width(area));
+	} else {
+		screencap_mark_dirty(area->x1, area->y1, area->x2, area->y2);
+		ili9488_video_flush_async(area->x1, area->y1, area->x2,
+					  area->y2, (void *)color_p,
+					  lv_area_get_size(area) *
+						  sizeof(lv_color_t));
+	}
+
+	/*Luma statistics while the DMA sends the same pixels*/
+	cabc_sample(color_p, lv_area_get_width(area), lv_area_get_height(area),
+		    lv_area_get_width(area));
+	if (lv_disp_flush_is_last(disp_drv))
+		cabc_frame_end();
+
+	ili9488_video_flush_wait();
+
+	PERF_SPAN_END(PERF_SPAN_FLUSH, flush);
+
+	report_first_pixel();
+
+	lv_disp_flush_ready(disp_drv);
+}
+
+#if DISP_RENDER_MODE != DISP_RENDER_PARTIAL
+/*
+ * The framebuffer is persistent and the panel keeps its own GRAM, so there is
+ * no need to send the whole frame. Walk the invalidated areas of the display
+ * being refreshed and send only them, skipping the ones joined into others.
+ */
+static void __attribute__((section(".time_critical.lvgl")))
+my_flush_direct_cb(lv_disp_drv_t *disp_drv, const lv_area_t *area,
+		   lv_color_t *color_p)
+{
+	lv_disp_t *disp = _lv_refr_get_disp_refreshing();
+	lv_area_t *inv;
+	int i;
+
+	/* the frame is complete only after the last area is rendered */
+	if (!lv_disp_flush_is_last(disp_drv)) {
+		lv_disp_flush_ready(disp_drv);
+		return;
+	}
+
+	PERF_SPAN_BEGIN(flush);
+
+	for (i = 0; i < disp->inv_p; i++) {
+		if (disp->inv_area_joined[i])
+			continue;
+
+		inv = &disp->inv_areas[i];
+		if (DISP_COLOR_INDEXED) {
+			my_flush_clut(inv,
+				      color_p + inv->y1 * disp_drv->hor_res +
+					      inv->x1,
+				      disp_drv->hor_res);
+			continue;
+		}
+		if (halfres_get()) {
+			my_flush_x2(inv,
+				    color_p + inv->y1 * disp_drv->hor_res +
+					    inv->x1,
+				    disp_drv->hor_res);
+			continue;
+		}
+
+		screencap_mark_dirty(inv->x1, inv->y1, inv->x2, inv->y2);
+		ili9488_video_batch_add(inv->x1, inv->y1, inv->x2, inv->y2,
+					(void *)color_p, disp_drv->hor_res);
+	}
+	/*All the areas go out with one kick, sample meanwhile*/
+	ili9488_video_batch_kick();
+
+	/*The framebuffer holds the whole frame, dark or not*/
+	cabc_sample(color_p, disp_drv->hor_res, disp_drv->ver_res,
+		    disp_drv->hor_res);
+	ili9488_video_flush_wait();
+	cabc_frame_end();
+
+	PERF_SPAN_END(PERF_SPAN_FLUSH, flush);
+
+	report_first_pixel();
 
 	lv_disp_flush_ready(disp_drv);
 }
+#endif
 
 /*Will be called by the library to read the touchpad*/
 static void __attribute__((section(".time_critical.lvgl")))
 my_touchpad_read(lv_indev_drv_t *indev_drv, lv_indev_data_t *data)
 {
-	static lv_coord_t last_x = 0;
-	static lv_coord_t last_y = 0;
-
-	/*Save the pressed coordinates and the state*/
-	if (ft6236_is_pressed()) {
-		last_x = ft6236_read_x();
-		last_y = ft6236_read_y();
+	static int16_t last_x = 0;
+	static int16_t last_y = 0;
+	uint16_t x, y;
+	uint32_t t_us;
+
+	PERF_SPAN_BEGIN(touch);
+
+	/*Save the pressed coordinates and the state, read in the background*/
+	if (ft6236_poll(&x, &y, &t_us)) {
+		/*Smooth and extrapolate, LVGL clips the point to the screen*/
+		last_x = x;
+		last_y = y;
+		touch_filter_update(&last_x, &last_y, t_us);
+		/*The filter caps are in panel pixels, halve them afterwards*/
+		last_x >>= halfres_get();
+		last_y >>= halfres_get();
 		// printf("touchpad is pressed, x: %d, y: %d\n", last_x, last_y);
 		data->state = LV_INDEV_STATE_PR;
 	} else {
+		touch_filter_reset(t_us);
 		data->state = LV_INDEV_STATE_REL;
 	}
 
+	/*Next read period and background read*/
+	touch_poll_update(data->state == LV_INDEV_STATE_PR, t_us);
+
+	PERF_SPAN_END(PERF_SPAN_TOUCH, touch);
+
 	/*Set the last pressed coordinates*/
 	data->point.x = last_x;
 	data->point.y = last_y;
 }
 
+#if PERF_STATS_ENABLED
+static void my_render_start_cb(lv_disp_drv_t *disp_drv)
+{
+	perf_frame_begin();
+}
+
+static void my_monitor_cb(lv_disp_drv_t *disp_drv, uint32_t time, uint32_t px)
+{
+	perf_frame_end(px);
+}
+#endif
+
 static void my_hardware_init(void)
 {
-	/* NOTE: DO NOT MODIFY THIS BLOCK */
-#define CPU_SPEED_MHZ (DEFAULT_SYS_CLK_KHZ / 1000)
-	if (CPU_SPEED_MHZ > 266 && CPU_SPEED_MHZ <= 360)
-		vreg_set_voltage(VREG_VOLTAGE_1_20);
-	else if (CPU_SPEED_MHZ > 360 && CPU_SPEED_MHZ <= 396)
-		vreg_set_voltage(VREG_VOLTAGE_1_25);
-	else if (CPU_SPEED_MHZ > 396)
-		vreg_set_voltage(VREG_VOLTAGE_MAX);
-	else
-		vreg_set_voltage(VREG_VOLTAGE_DEFAULT);
-
-	set_sys_clock_khz(CPU_SPEED_MHZ * 1000, true);
-	clock_configure(clk_peri, 0, CLOCKS_CLK_PERI_CTRL_AUXSRC_VALUE_CLK_SYS,
-			CPU_SPEED_MHZ * MHZ, CPU_SPEED_MHZ * MHZ);
+	struct clock_profile prof;
+
+	/* stored by the autotuner, CMake values otherwise */
+	clock_profile_load(&prof);
+	clock_profile_apply(&prof);
 	stdio_uart_init_full(uart0, 115200, 16, 17);
 	stdio_usb_init();
 
 	ili9488_driver_init();
+	my_clut_init();
 	ft6236_driver_init();
 
+	/* must come after the i80 bus claimed its DMA channel */
+	mem_ops_init();
+
+#if DISP_OVER_PIO
+	/* GRAM readback verifies the bus clock */
+	autotune_set_bus_check(ili9488_bus_check);
+#endif
+	autotune_boot();
+
 	gpio_init(PICO_DEFAULT_LED_PIN);
 	gpio_set_dir(PICO_DEFAULT_LED_PIN, GPIO_OUT);
 }
@@ -118,6 +324,9 @@ static void my_hardware_init(void)
 #if LVGL_USE_CORE1
 static void core1_entry(void)
 {
+	/*Parked in SRAM while core0 writes the flash or changes its clock*/
+	multicore_lockout_victim_init();
+
 	for (;;) {
 		lv_timer_handler_run_in_period(1);
 	}
@@ -130,11 +339,18 @@ int main(void)
 
 	my_hardware_init();
 
+#if RFB_SINK_ENABLED
+	/* the host draws, see rfb.c and tools/rfb_send.py */
+	backlight_driver_init();
+	backlight_set_level(100);
+	rfb_sink_run();
+#endif
+
 	/*Initialize LVGL*/
 	lv_init();
 
 	static lv_disp_draw_buf_t draw_buf_dsc_1;
-	static lv_color_t buf_1[MY_DISP_BUF_SIZE];
+	static lv_color_t buf_1[MY_DISP_BUF_SIZE] __attribute__((aligned(4)));
 
 	/*Initialize the display buffer*/
 	lv_disp_draw_buf_init(&draw_buf_dsc_1, buf_1, NULL, MY_DISP_BUF_SIZE);
@@ -146,27 +362,59 @@ int main(void)
 	lv_disp_drv_init(&disp_drv);
 
 	/*Set the resolution of the display*/
-	disp_drv.hor_res = LCD_HOR_RES;
-	disp_drv.ver_res = LCD_VER_RES;
+	disp_drv.hor_res = ili9488_get_xres();
+	disp_drv.ver_res = ili9488_get_yres();
 
 	/*Used to copy the buffer's content to the display*/
+#if DISP_RENDER_MODE == DISP_RENDER_DIRECT
+	disp_drv.direct_mode = 1;
+	disp_drv.flush_cb = my_flush_direct_cb;
+#elif DISP_RENDER_MODE == DISP_RENDER_FULL_REFRESH
+	disp_drv.full_refresh = 1;
+	disp_drv.flush_cb = my_flush_direct_cb;
+#else
 	disp_drv.flush_cb = my_flush_cb;
+#endif
 
 	/*Set a display buffer*/
 	disp_drv.draw_buf = &draw_buf_dsc_1;
 
+#if PERF_STATS_ENABLED
+	/*Render and flush time, XIP cache statistics*/
+	disp_drv.render_start_cb = my_render_start_cb;
+	disp_drv.monitor_cb = my_monitor_cb;
+#endif
+
 	/*Finally register the driver*/
-	lv_disp_drv_register(&disp_drv);
+	lv_disp_t *disp = lv_disp_drv_register(&disp_drv);
+
+	/*Cache rendered glyphs in front of the software letter renderer*/
+	glyph_cache_init(disp);
+
+	/*Rotate the display and touch together, LCD_ROTATION is the boot one*/
+	// rotation_set(disp, LCD_ROTATE_0);
 
 	/*Create an input device for touch handling*/
 	static lv_indev_drv_t indev_drv;
 	lv_indev_drv_init(&indev_drv);
 	indev_drv.type = LV_INDEV_TYPE_POINTER;
 	indev_drv.read_cb = my_touchpad_read;
-	lv_indev_drv_register(&indev_drv);
+	lv_indev_t *indev = lv_indev_drv_register(&indev_drv);
+
+	/*Fast touch polling while touched, slow when idle*/
+	touch_poll_init(indev);
+
+	perf_init();
+	screencap_init();
+	asset_init();
+	power_init();
+	cabc_init();
 
 	printf("Starting demo\n");
 	lv_demo_widgets();
+
+	/*Render the active screen at half resolution, see halfres.h*/
+	// halfres_screen(lv_scr_act(), true);
 	// lv_demo_keypad_encoder();
 	// lv_demo_stress();
 	// lv_demo_music();
@@ -176,6 +424,22 @@ int main(void)
 	// After  : Avg.181 282 150 222
 	// lv_demo_benchmark();
 
+	/* stored touch calibration, or the calibration screen over the demo */
+	touch_calib_init();
+	// touch_calib_start(NULL);
+
+	/* tune MEM_OPS_DMA_MEMCPY_MIN/MEMSET_MIN in mem_ops.h */
+	// mem_ops_benchmark();
+
+	/* flash saved by the packed fonts/images vs their decode time */
+	// asset_benchmark();
+
+	/* panel sleep/wake latency against PM_WAKE_BUDGET_US */
+	// power_benchmark();
+
+	/* pixel rate of the 8080 bus, compare LCD_PIN_DB_COUNT 16 and 8 */
+	// ili9488_bus_benchmark();
+
 	/* This is a factory test app */
 	// extern int factory_test(void);
 	// factory_test();
@@ -186,6 +450,8 @@ int main(void)
 	printf("backlight set to 100%%\n");
 
 #if LVGL_USE_CORE1
+	/*Power management may switch clocks from core1, park core0 as well*/
+	multicore_lockout_victim_init();
 	multicore_launch_core1(core1_entry);
 #endif
 
@@ -0,0 +1,241 @@
+// Copyright (c) 2026 embeddedboys developers
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#define pr_fmt(fmt) "mem_ops: " fmt
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "pico/time.h"
+#include "hardware/dma.h"
+
+#include "mem_ops.h"
+
+#define DRV_NAME "mem_ops"
+
+#define pr_debug   printf
+#define __ram_func __attribute__((section(".time_critical." DRV_NAME)))
+
+typedef unsigned int u32;
+typedef unsigned char u8;
+
+/*
+ * The channel is claimed after the i80 bus took its own one, -1 means there
+ * was no spare channel left and everything is done by the CPU.
+ */
+static int dma_chan = -1;
+static dma_channel_config dma_cfg;
+
+/* the DMA reads the fill pattern from here, keep it in SRAM */
+static volatile u32 memset_pattern;
+
+static void __ram_func mem_ops_dma_words(void *dst, const volatile void *src,
+					 size_t count, bool read_incr)
+{
+	dma_channel_config c = dma_cfg;
+
+	channel_config_set_read_increment(&c, read_incr);
+	dma_channel_configure(dma_chan, &c, dst, src, count, true);
+	dma_channel_wait_for_finish_blocking(dma_chan);
+}
+
+static void __ram_func cpu_memcpy_words(u32 *d, const u32 *s, size_t count)
+{
+	while (count >= 4) {
+		d[0] = s[0];
+		d[1] = s[1];
+		d[2] = s[2];
+		d[3] = s[3];
+		d += 4;
+		s += 4;
+		count -= 4;
+	}
+
+	while (count--)
+		*d++ = *s++;
+}
+
+static void __ram_func cpu_memset_words(u32 *d, u32 v, size_t count)
+{
+	while (count >= 4) {
+		d[0] = v;
+		d[1] = v;
+		d[2] = v;
+		d[3] = v;
+		d += 4;
+		count -= 4;
+	}
+
+	while (count--)
+		*d++ = v;
+}
+
+void *__ram_func mem_ops_memcpy(void *dst, const void *src, size_t len)
+{
+	u8 *d = dst;
+	const u8 *s = src;
+	size_t words;
+
+	/* can never be word aligned together, leave it to the libc */
+	if (((uintptr_t)d ^ (uintptr_t)s) & 3)
+		return memcpy(dst, src, len);
+
+	while (((uintptr_t)d & 3) && len) {
+		*d++ = *s++;
+		len--;
+	}
+
+	words = len >> 2;
+	if (dma_chan >= 0 && len >= MEM_OPS_DMA_MEMCPY_MIN)
+		mem_ops_dma_words(d, s, words, true);
+	else
+		cpu_memcpy_words((u32 *)d, (const u32 *)s, words);
+
+	d += words << 2;
+	s += words << 2;
+	len &= 3;
+
+	while (len--)
+		*d++ = *s++;
+
+	return dst;
+}
+
+void *__ram_func mem_ops_memset(void *dst, int c, size_t len)
+{
+	u8 *d = dst;
+	u32 v = (u8)c * 0x01010101u;
+	size_t words;
+
+	while (((uintptr_t)d & 3) && len) {
+		*d++ = (u8)c;
+		len--;
+	}
+
+	words = len >> 2;
+	if (dma_chan >= 0 && len >= MEM_OPS_DMA_MEMSET_MIN) {
+		memset_pattern = v;
+		mem_ops_dma_words(d, &memset_pattern, words, false);
+	} else {
+		cpu_memset_words((u32 *)d, v, words);
+	}
+
+	d += words << 2;
+	len &= 3;
+
+	while (len--)
+		*d++ = (u8)c;
+
+	return dst;
+}
+
+int mem_ops_init(void)
+{
+	dma_chan = dma_claim_unused_channel(false);
+	if (dma_chan < 0) {
+		pr_debug("no spare DMA channel, using CPU only\n");
+		return -1;
+	}
+
+	dma_cfg = dma_channel_get_default_config(dma_chan);
+	channel_config_set_transfer_data_size(&dma_cfg, DMA_SIZE_32);
+	channel_config_set_read_increment(&dma_cfg, true);
+	channel_config_set_write_increment(&dma_cfg, true);
+
+	pr_debug("using DMA channel %d\n", dma_chan);
+	return 0;
+}
+
+/* ########### benchmark ######## */
+#define BENCH_MAX_SIZE 16384
+#define BENCH_LOOPS    64
+
+static u32 bench_memcpy(void *dst, const void *src, size_t len, bool use_dma)
+{
+	int chan = dma_chan;
+	u32 start, i;
+
+	if (!use_dma)
+		dma_chan = -1;
+
+	start = time_us_32();
+	for (i = 0; i < BENCH_LOOPS; i++)
+		mem_ops_memcpy(dst, src, len);
+
+	dma_chan = chan;
+	return time_us_32() - start;
+}
+
+static u32 bench_memset(void *dst, size_t len, bool use_dma)
+{
+	int chan = dma_chan;
+	u32 start, i;
+
+	if (!use_dma)
+		dma_chan = -1;
+
+	start = time_us_32();
+	for (i = 0; i < BENCH_LOOPS; i++)
+		mem_ops_memset(dst, 0x5a, len);
+
+	dma_chan = chan;
+	return time_us_32() - start;
+}
+
+/*
+ * Print CPU versus DMA timings for growing block sizes, the first size
+ * where DMA wins is a good value for MEM_OPS_DMA_MEMCPY_MIN/MEMSET_MIN.
+ */
+void mem_ops_benchmark(void)
+{
+	u32 *src, *dst;
+	size_t len;
+
+	if (dma_chan < 0) {
+		pr_debug("benchmark needs a DMA channel\n");
+		return;
+	}
+
+	src = malloc(BENCH_MAX_SIZE);
+	dst = malloc(BENCH_MAX_SIZE);
+	if (!src || !dst) {
+		pr_debug("benchmark out of memory\n");
+		goto out;
+	}
+
+	pr_debug("%d loops, time in us\n", BENCH_LOOPS);
+	pr_debug("%8s %10s %10s %10s %10s\n", "size", "cpy(cpu)", "cpy(dma)",
+		 "set(cpu)", "set(dma)");
+	for (len = 16; len <= BENCH_MAX_SIZE; len <<= 1) {
+		pr_debug("%8u %10u %10u %10u %10u\n", len,
+			 bench_memcpy(dst, src, len, false),
+			 bench_memcpy(dst, src, len, true),
+			 bench_memset(dst, len, false),
+			 bench_memset(dst, len, true));
+	}
+
+out:
+	free(src);
+	free(dst);
+}
+/* ########### benchmark ######## */
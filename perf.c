@@ -0,0 +1,135 @@
+// Copyright (c) 2026 embeddedboys developers
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <stdio.h>
+#include <string.h>
+
+#include "pico/time.h"
+#include "hardware/structs/xip_ctrl.h"
+
+#include "lvgl/lvgl.h"
+
+#include "perf.h"
+
+#define DRV_NAME "perf"
+
+#define pr_debug   printf
+#define __ram_func __attribute__((section(".time_critical." DRV_NAME)))
+
+#if PERF_STATS_ENABLED
+
+#define PERF_REPORT_PERIOD_MS 1000
+
+struct perf_span {
+	uint32_t count;
+	uint32_t us;
+	uint32_t hit;
+	uint32_t acc;
+};
+
+static struct perf_span spans[PERF_SPAN_MAX];
+static struct perf_mark frame_mark;
+static uint32_t frame_px;
+
+static const char *span_names[PERF_SPAN_MAX] = {
+	[PERF_SPAN_FRAME] = "frame",
+	[PERF_SPAN_FLUSH] = "flush",
+	[PERF_SPAN_TOUCH] = "touch",
+	[PERF_SPAN_CABC] = "cabc",
+};
+
+void __ram_func perf_span_add(enum perf_span_id id,
+			      const struct perf_mark *begin)
+{
+	struct perf_span *span = &spans[id];
+	struct perf_mark end;
+
+	perf_mark(&end);
+
+	span->count++;
+	span->us += end.us - begin->us;
+	span->hit += end.hit - begin->hit;
+	span->acc += end.acc - begin->acc;
+}
+
+void __ram_func perf_frame_begin(void)
+{
+	perf_mark(&frame_mark);
+}
+
+void __ram_func perf_frame_end(uint32_t px)
+{
+	perf_span_add(PERF_SPAN_FRAME, &frame_mark);
+	frame_px += px;
+}
+
+/* hit rate in 0.1% */
+static uint32_t perf_hit_rate(const struct perf_span *span)
+{
+	if (!span->acc)
+		return 1000;
+
+	return (uint64_t)span->hit * 1000 / span->acc;
+}
+
+static uint32_t perf_avg_us(const struct perf_span *span)
+{
+	return span->count ? span->us / span->count : 0;
+}
+
+static void perf_report_cb(lv_timer_t *timer)
+{
+	struct perf_span snap[PERF_SPAN_MAX];
+	struct perf_span *frame = &snap[PERF_SPAN_FRAME];
+	struct perf_span *flush = &snap[PERF_SPAN_FLUSH];
+	uint32_t render_us, rate;
+	int i;
+
+	memcpy(snap, spans, sizeof(spans));
+	memset(spans, 0, sizeof(spans));
+
+	/* flushing is synchronous, the rest of a frame is rendering */
+	render_us = frame->us > flush->us ? frame->us - flush->us : 0;
+	render_us = frame->count ? render_us / frame->count : 0;
+
+	pr_debug("perf: %u fps, %u px, render %u us, flush %u us/frame\n",
+		 frame->count * 1000 / PERF_REPORT_PERIOD_MS, frame_px, render_us,
+		 frame->count ? flush->us / frame->count : 0);
+	frame_px = 0;
+
+	for (i = 0; i < PERF_SPAN_MAX; i++) {
+		if (!snap[i].count)
+			continue;
+
+		rate = perf_hit_rate(&snap[i]);
+		pr_debug("perf: %-6s %6u calls, avg %6u us, xip hit %3u.%u%%, %u miss\n",
+			 span_names[i], snap[i].count, perf_avg_us(&snap[i]),
+			 rate / 10, rate % 10, snap[i].acc - snap[i].hit);
+	}
+}
+
+void perf_init(void)
+{
+	memset(spans, 0, sizeof(spans));
+	lv_timer_create(perf_report_cb, PERF_REPORT_PERIOD_MS, NULL);
+}
+
+#endif
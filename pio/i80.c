@@ -20,6 +20,7 @@
 // WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include <stdio.h>
+#include <string.h>
 
 #include "pico/time.h"
 #include "pico/stdlib.h"
@@ -32,9 +33,77 @@
 
 #include "boards/pico.h"
 #include "i80.pio.h"
+#include "lcd_seq.h"
 
 static PIO g_pio = pio0;
 static uint g_sm = 0;
+static uint g_sm_rd = 1;
+static uint g_sm_stream = 2;
+/* the address generator runs on its own, pio0 has no room left for it */
+static PIO g_pio_clut = pio1;
+static int g_sm_clut;
+static uint g_offset;
+static uint g_pin_wr;
+static uint g_stream_offset;
+static bool g_sm_ready = false;
+static uint32_t g_wr_clk_khz = I80_BUS_WR_CLK_KHZ;
+static uint32_t g_wr_clk_max_khz;
+
+/* the clut state machine builds entry addresses out of the low 9 bits */
+static uint16_t g_clut[256] __attribute__((aligned(512)));
+
+/* an integer part of 0 would mean 65536, run at clk_peri instead */
+static float i80_clamp_clk_div(float div)
+{
+    return div < 1.f ? 1.f : div;
+}
+
+/* each write cycle takes two PIO cycles, WR low and WR high */
+static float i80_get_clk_div(uint32_t wr_clk_khz)
+{
+    return i80_clamp_clk_div(clock_get_hz(clk_peri) / 1000.f / 2.f / wr_clk_khz);
+}
+
+static float i80_get_rd_clk_div(void)
+{
+    return i80_clamp_clk_div(clock_get_hz(clk_peri) / 1000.f / I80_RD_CYCLES_PER_WORD /
+                             I80_BUS_RD_CLK_KHZ);
+}
+
+/*
+ * Set the WR strobe frequency, can be called before i80_pio_init() and
+ * again whenever clk_peri changed.
+ */
+void i80_set_bus_clk_khz(uint32_t khz)
+{
+    if (g_wr_clk_max_khz && khz > g_wr_clk_max_khz)
+        khz = g_wr_clk_max_khz;
+
+    g_wr_clk_khz = khz;
+
+    if (g_sm_ready) {
+        pio_sm_set_clkdiv(g_pio, g_sm, i80_get_clk_div(khz));
+        pio_sm_set_clkdiv(g_pio, g_sm_rd, i80_get_rd_clk_div());
+        pio_sm_set_clkdiv(g_pio, g_sm_stream, i80_get_clk_div(khz));
+    }
+}
+
+/* the write cycle limit of the controller on the bus, 0: none */
+void i80_set_bus_clk_max_khz(uint32_t khz)
+{
+    g_wr_clk_max_khz = khz;
+    i80_set_bus_clk_khz(g_wr_clk_khz);
+}
+
+uint32_t i80_get_bus_clk_max_khz(void)
+{
+    return g_wr_clk_max_khz;
+}
+
+uint32_t i80_get_bus_clk_khz(void)
+{
+    return g_wr_clk_khz;
+}
 
 void __time_critical_func(i80_set_rs_cs)(bool rs, bool cs)
 {
@@ -46,11 +115,62 @@ void __time_critical_func(i80_set_rs)(bool rs)
     gpio_put_masked(1u << LCD_PIN_RS, !!rs << LCD_PIN_RS);
 }
 
+/*
+ * Hand RS over to the stream state machine and start it, the bus must be
+ * idle. ISR gets the delay loop count per microsecond.
+ */
+static void i80_stream_start(void)
+{
+    /* the state machine runs at two cycles per WR strobe */
+    uint32_t per_us = g_wr_clk_khz * 2 / 1000;
+
+    per_us = per_us > I80_STREAM_US_OVERHEAD ? per_us - I80_STREAM_US_OVERHEAD : 0;
+
+    i80_wait_idle(g_pio, g_sm);
+
+    pio_sm_put_blocking(g_pio, g_sm_stream, per_us);
+    pio_sm_exec(g_pio, g_sm_stream, pio_encode_pull(false, true));
+    pio_sm_exec(g_pio, g_sm_stream, pio_encode_mov(pio_isr, pio_osr));
+    /* or the pull at next is a no-op, autopull is on */
+    pio_sm_exec(g_pio, g_sm_stream, pio_encode_out(pio_null, 32));
+    pio_sm_exec(g_pio, g_sm_stream, pio_encode_jmp(g_stream_offset + i80_stream_offset_next));
+
+    gpio_set_function(LCD_PIN_RS, GPIO_FUNC_PIO0 + pio_get_index(g_pio));
+    pio_sm_set_enabled(g_pio, g_sm_stream, true);
+}
+
+static void i80_stream_stop(void)
+{
+    i80_wait_idle(g_pio, g_sm_stream);
+
+    pio_sm_set_enabled(g_pio, g_sm_stream, false);
+    gpio_set_function(LCD_PIN_RS, GPIO_FUNC_SIO);
+}
+
 #if PIO_USE_DMA
 /* DMA version */
 static uint dma_tx;
+static uint dma_ctrl;
 static dma_channel_config c;
-static inline void __time_critical_func(i80_write_pio16_wr)(PIO pio, uint sm, void *buf, size_t len)
+static dma_channel_config c_stream;
+static uint dma_clut_feed;
+static dma_channel_config c_x2, c_x2_ctrl;
+static dma_channel_config c_clut, c_clut_addr, c_clut_feed;
+static dma_channel_config c_blk, c_blk_ctrl;
+static bool g_async_pending;
+static bool g_x2_pending;
+static bool g_blk_pending;
+
+/* where the control channel stops reading, NULL: it is not in use */
+static const void *g_ctrl_end;
+
+/* half of the long side of a 480x320 panel, taller areas go in chunks */
+#define I80_X2_MAX_LINES 240
+
+/* every line twice and the null that stops the control channel */
+static const uint16_t *g_x2_lines[I80_X2_MAX_LINES * 2 + 1];
+
+static inline void __time_critical_func(i80_write_pio16_wr_start)(PIO pio, uint sm, void *buf, size_t len)
 {
     dma_channel_configure(dma_tx, &c,
                           &pio->txf[sm], /* write address */
@@ -58,12 +178,48 @@ static inline void __time_critical_func(i80_write_pio16_wr)(PIO pio, uint sm, vo
                           len / 2, /* element count (each element is of size transfer_data_size) */
                           true /* start right now */
     );
+}
+
+static inline void __time_critical_func(i80_write_pio16_wr)(PIO pio, uint sm, void *buf, size_t len)
+{
+    i80_write_pio16_wr_start(pio, sm, buf, len);
 
     // dma_start_channel_mask(1u << dma_tx);
 
     /* TODO: use another core to wait. */
     dma_channel_wait_for_finish_blocking(dma_tx);
 }
+
+/*
+ * Wait for the transfer started by i80_write_buf_rs_async(), the last word
+ * has left the FIFO only when the state machine stalls.
+ */
+void __time_critical_func(i80_write_wait)(void)
+{
+    if (!g_async_pending)
+        return;
+
+    /* the control channel is done once it handed over the null */
+    if (g_ctrl_end) {
+        while (dma_hw->ch[dma_ctrl].read_addr != (uintptr_t)g_ctrl_end ||
+               dma_channel_is_busy(dma_ctrl))
+            tight_loop_contents();
+        g_ctrl_end = NULL;
+    }
+
+    dma_channel_wait_for_finish_blocking(dma_tx);
+    i80_wait_idle(g_pio, g_sm);
+
+    if (g_x2_pending) {
+        i80_set_repeat(g_pio, g_sm, g_offset, false);
+        g_x2_pending = false;
+    }
+    if (g_blk_pending) {
+        i80_stream_stop();
+        g_blk_pending = false;
+    }
+    g_async_pending = false;
+}
 #else
 static inline int i80_write_pio16_wr(PIO pio, uint sm, void *buf, size_t len)
 {
@@ -81,17 +237,244 @@ static inline int i80_write_pio16_wr(PIO pio, uint sm, void *buf, size_t len)
     i80_wait_idle(pio, sm);
     return 0;
 }
+
+void i80_write_wait(void)
+{
+}
 #endif
 
 void __time_critical_func(i80_write_buf_rs)(void *buf, size_t len, bool rs)
 {
+    /* an async transfer may still be running, RS must not change under it */
+    i80_write_wait();
     i80_set_rs(rs);
     i80_write_pio16_wr(g_pio, g_sm, buf, len);
 }
 
-int i80_pio_init(uint8_t db_base, uint8_t db_count, uint8_t pin_wr)
+/*
+ * Start writing `buf` and return, the buffer must stay untouched until
+ * i80_write_wait() returns. Any other bus access waits for it first.
+ */
+void __time_critical_func(i80_write_buf_rs_async)(void *buf, size_t len, bool rs)
+{
+#if PIO_USE_DMA
+    i80_write_wait();
+    i80_set_rs(rs);
+    i80_write_pio16_wr_start(g_pio, g_sm, buf, len);
+    g_async_pending = true;
+#else
+    i80_write_buf_rs(buf, len, rs);
+#endif
+}
+
+/*
+ * Pixel doubling for half resolution rendering, `h` lines of `w` pixels that
+ * are `stride` pixels apart cover 2w x 2h on the panel. The state machine
+ * strobes every pixel twice, the data channel reads every line twice, from
+ * a list of line addresses a second channel feeds it with. Returns once
+ * started, like i80_write_buf_rs_async().
+ */
+void __time_critical_func(i80_write_buf_x2_async)(const void *buf, size_t w, size_t h,
+                                                  size_t stride)
+{
+    const uint16_t *p = buf;
+#if PIO_USE_DMA
+    size_t n, i;
+
+    while (h) {
+        n = h < I80_X2_MAX_LINES ? h : I80_X2_MAX_LINES;
+
+        i80_write_wait();
+        i80_set_rs(1);
+        i80_set_repeat(g_pio, g_sm, g_offset, true);
+
+        for (i = 0; i < n; i++) {
+            g_x2_lines[i * 2] = p;
+            g_x2_lines[i * 2 + 1] = p;
+            p += stride;
+        }
+        g_x2_lines[n * 2] = NULL;
+        g_ctrl_end = &g_x2_lines[n * 2 + 1];
+        g_x2_pending = true;
+
+        dma_channel_configure(dma_tx, &c_x2, &g_pio->txf[g_sm], NULL, w, false);
+        dma_channel_configure(dma_ctrl, &c_x2_ctrl,
+                              &dma_hw->ch[dma_tx].al3_read_addr_trig,
+                              g_x2_lines, 1, true);
+        g_async_pending = true;
+
+        h -= n;
+    }
+#else
+    size_t x, y;
+
+    i80_set_rs(1);
+    i80_set_repeat(g_pio, g_sm, g_offset, true);
+    for (y = 0; y < h * 2; y++) {
+        for (x = 0; x < w; x++)
+            i80_put(g_pio, g_sm, p[x]);
+        if (y & 1)
+            p += stride;
+    }
+    i80_set_repeat(g_pio, g_sm, g_offset, false);
+#endif
+}
+
+/* the RGB565 colours of 8-bit indexed pixels */
+void i80_set_clut(const uint16_t *clut)
+{
+    /* the table may be in use */
+    i80_write_wait();
+    memcpy(g_clut, clut, sizeof(g_clut));
+}
+
+/*
+ * 8-bit indexed pixels expanded through the table of i80_set_clut() on the
+ * way out, `h` lines of `w` pixels that are `stride` pixels apart. The feed
+ * channel sends indices to the clut state machine, the address channel
+ * passes its entry addresses on to the data channel, one pixel per trigger.
+ * Returns once sent.
+ */
+void i80_write_buf_clut(const void *buf, size_t w, size_t h, size_t stride)
+{
+    const uint8_t *p = buf;
+#if PIO_USE_DMA
+    /* contiguous lines go in one feed */
+    if (stride == w) {
+        w *= h;
+        h = 1;
+    }
+
+    i80_write_wait();
+    i80_set_rs(1);
+
+    dma_channel_configure(dma_tx, &c_clut, &g_pio->txf[g_sm], NULL, 1, false);
+    dma_channel_configure(dma_ctrl, &c_clut_addr,
+                          &dma_hw->ch[dma_tx].al3_read_addr_trig,
+                          &g_pio_clut->rxf[g_sm_clut], 1, true);
+
+    while (h--) {
+        dma_channel_configure(dma_clut_feed, &c_clut_feed,
+                              &g_pio_clut->txf[g_sm_clut], p, w, true);
+        dma_channel_wait_for_finish_blocking(dma_clut_feed);
+        p += stride;
+    }
+
+    /*
+     * Once the last index went through, a null address stops the chain,
+     * the address channel has handed it over when the FIFO is empty.
+     */
+    i80_wait_idle(g_pio_clut, g_sm_clut);
+    pio_sm_exec(g_pio_clut, g_sm_clut, pio_encode_in(pio_null, 32));
+    while (!pio_sm_is_rx_fifo_empty(g_pio_clut, g_sm_clut) ||
+           dma_channel_is_busy(dma_ctrl))
+        tight_loop_contents();
+
+    i80_wait_idle(g_pio, g_sm);
+#else
+    size_t x;
+
+    i80_set_rs(1);
+    while (h--) {
+        for (x = 0; x < w; x++)
+            i80_put(g_pio, g_sm, g_clut[p[x]]);
+        p += stride;
+    }
+    i80_wait_idle(g_pio, g_sm);
+#endif
+}
+
+/*
+ * Send a command stream built with include/lcd_seq.h, RS and the delays are
+ * in the words. The stream state machine takes RS over from SIO meanwhile.
+ */
+void i80_write_stream(const uint32_t *words, size_t count)
+{
+    i80_write_wait();
+    i80_stream_start();
+
+#if PIO_USE_DMA
+    dma_channel_configure(dma_tx, &c_stream, &g_pio->txf[g_sm_stream], words,
+                          count, true);
+    dma_channel_wait_for_finish_blocking(dma_tx);
+#else
+    while (count--)
+        pio_sm_put_blocking(g_pio, g_sm_stream, *words++);
+#endif
+
+    i80_stream_stop();
+}
+
+/*
+ * Send a stream split over blocks, `blk[n]` is the {0, NULL} that ends it.
+ * The control channel writes each block's count and read address into the
+ * data channel, which chains back to it, so the whole list goes out with
+ * one kick. The blocks and what they point at must stay untouched until
+ * i80_write_wait() returns, words are read 32 bits at a time.
+ */
+void __time_critical_func(i80_write_stream_blk_async)(const struct lcd_seq_blk *blk, size_t n)
+{
+    i80_write_wait();
+    i80_stream_start();
+
+#if PIO_USE_DMA
+    g_ctrl_end = &blk[n + 1];
+    g_blk_pending = true;
+    g_async_pending = true;
+
+    dma_channel_configure(dma_tx, &c_blk, &g_pio->txf[g_sm_stream], NULL, 0, false);
+    dma_channel_configure(dma_ctrl, &c_blk_ctrl,
+                          &dma_hw->ch[dma_tx].al3_transfer_count, blk, 2, true);
+#else
+    const uint32_t *words;
+    uint32_t count;
+
+    for (; blk->read; blk++) {
+        words = blk->read;
+        for (count = blk->count; count; count--)
+            pio_sm_put_blocking(g_pio, g_sm_stream, *words++);
+    }
+
+    i80_stream_stop();
+#endif
+}
+
+/*
+ * Read `len` bytes, the read state machine turns the data bus around for
+ * the transfer and drives it again before it goes idle.
+ */
+int i80_read_buf_rs(void *buf, size_t len, bool rs)
+{
+    uint16_t *p = buf;
+    size_t count = len / 2;
+
+    if (!count)
+        return 0;
+
+    /* the write side must be done, WR inactive, before the bus is released */
+    i80_write_wait();
+    i80_wr_park(g_pio, g_sm, g_pin_wr, true);
+    if (!gpio_get(g_pin_wr)) {
+        i80_wr_park(g_pio, g_sm, g_pin_wr, false);
+        return -1;
+    }
+
+    i80_set_rs(rs);
+    pio_sm_put_blocking(g_pio, g_sm_rd, count - 1);
+    while (count--)
+        *p++ = (uint16_t)pio_sm_get_blocking(g_pio, g_sm_rd);
+
+    /* and back to writing only once the bus is driven again */
+    i80_wait_idle(g_pio, g_sm_rd);
+    i80_wr_park(g_pio, g_sm, g_pin_wr, false);
+
+    return 0;
+}
+
+int i80_pio_init(uint8_t db_base, uint8_t db_count, uint8_t pin_wr, uint8_t pin_rd)
 {
     printf("i80 PIO initialzing...\n");
+    g_pin_wr = pin_wr;
 
 #if PIO_USE_DMA
     dma_tx = dma_claim_unused_channel(true);
@@ -99,11 +482,71 @@ int i80_pio_init(uint8_t db_base, uint8_t db_count, uint8_t pin_wr)
 
     channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
     channel_config_set_dreq(&c, pio_get_dreq(g_pio, g_sm, true));
+
+    c_stream = dma_channel_get_default_config(dma_tx);
+    channel_config_set_transfer_data_size(&c_stream, DMA_SIZE_32);
+    channel_config_set_dreq(&c_stream, pio_get_dreq(g_pio, g_sm_stream, true));
+
+    /* one line per trigger, then the control channel loads the next one */
+    dma_ctrl = dma_claim_unused_channel(true);
+    c_x2 = c;
+    channel_config_set_chain_to(&c_x2, dma_ctrl);
+
+    c_x2_ctrl = dma_channel_get_default_config(dma_ctrl);
+    channel_config_set_transfer_data_size(&c_x2_ctrl, DMA_SIZE_32);
+    channel_config_set_read_increment(&c_x2_ctrl, true);
+    channel_config_set_write_increment(&c_x2_ctrl, false);
+
+    /* indexed pixels, a colour table entry per trigger as above */
+    dma_clut_feed = dma_claim_unused_channel(true);
+    c_clut = c_x2;
+
+    c_clut_addr = dma_channel_get_default_config(dma_ctrl);
+    channel_config_set_transfer_data_size(&c_clut_addr, DMA_SIZE_32);
+    channel_config_set_read_increment(&c_clut_addr, false);
+    channel_config_set_write_increment(&c_clut_addr, false);
+    channel_config_set_dreq(&c_clut_addr, pio_get_dreq(g_pio_clut, g_sm_clut, false));
+
+    c_clut_feed = dma_channel_get_default_config(dma_clut_feed);
+    channel_config_set_transfer_data_size(&c_clut_feed, DMA_SIZE_8);
+    channel_config_set_dreq(&c_clut_feed, pio_get_dreq(g_pio_clut, g_sm_clut, true));
+
+    /* stream blocks, the control channel writes {count, read} of the next */
+    c_blk = c_stream;
+    channel_config_set_chain_to(&c_blk, dma_ctrl);
+
+    c_blk_ctrl = dma_channel_get_default_config(dma_ctrl);
+    channel_config_set_transfer_data_size(&c_blk_ctrl, DMA_SIZE_32);
+    channel_config_set_read_increment(&c_blk_ctrl, true);
+    channel_config_set_write_increment(&c_blk_ctrl, true);
+    channel_config_set_ring(&c_blk_ctrl, true, 3);
 #endif
 
-    uint offset = pio_add_program(g_pio, &i80_program);
-    float clk_div = (DEFAULT_PIO_CLK_KHZ / 2.f / I80_BUS_WR_CLK_KHZ);
-    i80_program_init(g_pio, g_sm, offset, db_base, db_count, pin_wr, clk_div);
+    uint offset;
+    float clk_div = i80_get_clk_div(g_wr_clk_khz);
+    if (db_count == 8) {
+        offset = pio_add_program(g_pio, &i80_8_program);
+        i80_8_program_init(g_pio, g_sm, offset, db_base, pin_wr, clk_div);
+    } else {
+        offset = pio_add_program(g_pio, &i80_program);
+        i80_program_init(g_pio, g_sm, offset, db_base, db_count, pin_wr, clk_div);
+    }
+    g_offset = offset;
+
+    offset = pio_add_program(g_pio, &i80_rd_program);
+    i80_rd_program_init(g_pio, g_sm_rd, offset, db_base, db_count, pin_rd,
+                        i80_get_rd_clk_div());
+
+    g_stream_offset = pio_add_program(g_pio, &i80_stream_program);
+    i80_stream_program_init(g_pio, g_sm_stream, g_stream_offset, db_base, db_count,
+                            pin_wr, LCD_PIN_RS, clk_div);
+
+#if PIO_USE_DMA
+    g_sm_clut = pio_claim_unused_sm(g_pio_clut, true);
+    offset = pio_add_program(g_pio_clut, &i80_clut_program);
+    i80_clut_program_init(g_pio_clut, g_sm_clut, offset, g_clut);
+#endif
+    g_sm_ready = true;
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,229 @@
+// Copyright (c) 2026 embeddedboys developers
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#define pr_fmt(fmt) "power: " fmt
+
+#include <stdio.h>
+
+#include "pico/stdlib.h"
+#include "hardware/gpio.h"
+#include "hardware/sync.h"
+
+#include "lvgl/lvgl.h"
+
+#include "ili9488.h"
+#include "ft6236.h"
+#include "backlight.h"
+#include "autotune.h"
+#include "power.h"
+
+#if POWER_MGR_ENABLED
+
+#if PM_SLEEP_MS <= PM_DIM_MS
+#error "PM_SLEEP_MS must be longer than PM_DIM_MS"
+#endif
+
+#define pr_debug printf
+
+#define PM_TICK_MS	   100
+#define PM_BENCH_CYCLES	   10
+#define PM_BENCH_SLEEP_MS  200
+
+struct power {
+	struct clock_profile active;
+	struct clock_profile sleep;
+
+	bool dimmed;
+	u8 level; /* to go back to after dimming */
+
+	volatile bool touch_irq;
+};
+
+static struct power g_power;
+
+static void power_dim(struct power *pm, bool dim)
+{
+	if (dim == pm->dimmed)
+		return;
+
+	pm->dimmed = dim;
+	if (dim) {
+		pm->level = backlight_get_level();
+		backlight_fade_to(PM_DIM_LEVEL, PM_DIM_FADE_MS, BL_EASE_IN_OUT);
+	} else {
+		/* get_level() has the offset added already */
+		backlight_fade_to(pm->level > backlight_get_offset() ?
+					  pm->level - backlight_get_offset() :
+					  0,
+				  PM_WAKE_FADE_MS, BL_EASE_OUT);
+	}
+}
+
+#if FT6236_PIN_INT >= 0
+static void power_touch_irq(uint gpio, uint32_t events)
+{
+	g_power.touch_irq = true;
+}
+
+static void power_wait_touch(struct power *pm)
+{
+	pm->touch_irq = false;
+	gpio_set_irq_enabled_with_callback(FT6236_PIN_INT, GPIO_IRQ_EDGE_FALL,
+					   true, power_touch_irq);
+	while (!pm->touch_irq)
+		__wfi();
+	gpio_set_irq_enabled(FT6236_PIN_INT, GPIO_IRQ_EDGE_FALL, false);
+}
+#else
+/* sleep_ms() waits for the timer alarm in WFE */
+static void power_wait_touch(struct power *pm)
+{
+	do {
+		sleep_ms(PM_SLEEP_POLL_MS);
+	} while (!ft6236_is_pressed());
+}
+#endif
+
+/*
+ * No refresh may reach the panel in sleep-in, wherever LVGL runs. The
+ * refresh timer is held and the flush in progress, if any, waited for.
+ */
+static void power_enter(struct power *pm)
+{
+	lv_timer_pause(_lv_disp_get_refr_timer(NULL));
+	ili9488_video_flush_wait();
+
+	backlight_set_power(false);
+	ili9488_set_blank(true);
+	ili9488_set_sleep(true);
+
+	clock_profile_switch(&pm->sleep);
+}
+
+static void power_exit(struct power *pm, uint32_t t0,
+		       struct power_wake_stats *st)
+{
+	clock_profile_switch(&pm->active);
+	st->clk_us = time_us_32() - t0;
+
+	ili9488_set_sleep(false);
+	ili9488_set_blank(false);
+	if (pm->dimmed)
+		power_dim(pm, false);
+	else
+		backlight_set_power(true);
+	st->panel_us = time_us_32() - t0;
+
+	/* GRAM survived, only what changed meanwhile is redrawn */
+	lv_timer_resume(_lv_disp_get_refr_timer(NULL));
+	lv_disp_trig_activity(NULL);
+	lv_refr_now(NULL);
+	st->frame_us = time_us_32() - t0;
+}
+
+static void power_report(const char *what, const struct power_wake_stats *st)
+{
+	pr_debug("power: %s clock %u us, panel %u us, frame %u us, budget %u us%s\n",
+		 what, st->clk_us, st->panel_us, st->frame_us,
+		 PM_WAKE_BUDGET_US,
+		 st->frame_us > PM_WAKE_BUDGET_US ? " EXCEEDED" : "");
+}
+
+/* sleep now, returns once woken by a touch and the finger is up again */
+void power_sleep(void)
+{
+	struct power *pm = &g_power;
+	struct power_wake_stats st;
+	uint32_t t0;
+
+	pr_debug("power: sleeping\n");
+	power_enter(pm);
+
+	power_wait_touch(pm);
+	t0 = time_us_32();
+
+	power_exit(pm, t0, &st);
+	power_report("woke,", &st);
+
+	/* the waking touch is not a click */
+	while (ft6236_is_pressed())
+		sleep_ms(10);
+}
+
+static void power_timer_cb(lv_timer_t *timer)
+{
+	struct power *pm = &g_power;
+	uint32_t inactive = lv_disp_get_inactive_time(NULL);
+
+	if (inactive >= PM_SLEEP_MS) {
+		power_sleep();
+		return;
+	}
+
+	power_dim(pm, inactive >= PM_DIM_MS);
+}
+
+/* sleep/wake cycles with a simulated touch, worst case of each stage */
+void power_benchmark(void)
+{
+	struct power *pm = &g_power;
+	struct power_wake_stats st, max = { 0 };
+	uint32_t t0;
+	int i;
+
+	for (i = 0; i < PM_BENCH_CYCLES; i++) {
+		t0 = time_us_32();
+		power_enter(pm);
+		pr_debug("power: enter %u us\n", time_us_32() - t0);
+
+		sleep_ms(PM_BENCH_SLEEP_MS);
+
+		power_exit(pm, time_us_32(), &st);
+		max.clk_us = LV_MAX(max.clk_us, st.clk_us);
+		max.panel_us = LV_MAX(max.panel_us, st.panel_us);
+		max.frame_us = LV_MAX(max.frame_us, st.frame_us);
+		sleep_ms(PM_BENCH_SLEEP_MS);
+	}
+
+	power_report("worst wake,", &max);
+}
+
+void power_init(void)
+{
+	struct power *pm = &g_power;
+
+	clock_profile_load(&pm->active);
+	pm->sleep = pm->active;
+	pm->sleep.sys_khz = PM_SLEEP_SYS_KHZ;
+	pm->sleep.flash_div = clock_profile_flash_div(PM_SLEEP_SYS_KHZ);
+	/* clk_peri follows clk_sys, a WR strobe takes two PIO cycles */
+	pm->sleep.bus_khz = LV_MIN(pm->active.bus_khz, PM_SLEEP_SYS_KHZ / 2);
+
+#if FT6236_PIN_INT >= 0
+	gpio_init(FT6236_PIN_INT);
+	gpio_pull_up(FT6236_PIN_INT);
+#endif
+
+	lv_timer_create(power_timer_cb, PM_TICK_MS, NULL);
+}
+
+#endif
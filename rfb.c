@@ -0,0 +1,209 @@
+// Copyright (c) 2026 embeddedboys developers
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+/*
+ * Remote framebuffer sink.
+ *
+ * core0 receives the packets from USB into two slots, core1 decodes them
+ * into two pixel buffers and starts the DMA to the panel. While one buffer
+ * is on the bus the next rectangle is decoded into the other one, and
+ * meanwhile core0 is already receiving the packet after it.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "pico/stdlib.h"
+#include "pico/stdio_usb.h"
+#include "pico/multicore.h"
+
+#include "ili9488.h"
+#include "rfb.h"
+
+#define DRV_NAME "rfb"
+
+#define pr_debug   printf
+#define __ram_func __attribute__((section(".time_critical." DRV_NAME)))
+
+typedef unsigned int u32;
+typedef unsigned short u16;
+typedef unsigned char u8;
+
+#define RFB_SLOTS 2
+
+struct rfb_rx {
+	struct rfb_hdr hdr;
+	u8 data[RFB_RX_SIZE];
+};
+
+static struct rfb_rx rx_slots[RFB_SLOTS];
+static u16 pix_bufs[2][RFB_BUF_PX];
+static volatile u32 rfb_errors;
+
+static void rfb_read(void *buf, size_t len)
+{
+	u8 *p = buf;
+	int n;
+
+	while (len) {
+		n = stdio_usb.in_chars((char *)p, len);
+		if (n <= 0) {
+			tight_loop_contents();
+			continue;
+		}
+		p += n;
+		len -= n;
+	}
+}
+
+static bool rfb_hdr_valid(const struct rfb_hdr *hdr)
+{
+	if (hdr->type == RFB_SYNC)
+		return hdr->len == 0;
+
+	if (hdr->type < RFB_RECT_RAW || hdr->type > RFB_RECT_LZ4)
+		return false;
+
+	return hdr->len <= RFB_RX_SIZE && hdr->w && hdr->h &&
+	       hdr->w * hdr->h <= RFB_BUF_PX &&
+	       hdr->x + hdr->w <= ili9488_get_xres() &&
+	       hdr->y + hdr->h <= ili9488_get_yres();
+}
+
+/* scan for the magic, bad headers are skipped one byte at a time */
+static void rfb_read_hdr(struct rfb_hdr *hdr)
+{
+	u8 *p = (u8 *)hdr;
+
+	for (;;) {
+		rfb_read(&p[0], 1);
+		if (p[0] != RFB_MAGIC0)
+			continue;
+
+		rfb_read(&p[1], 1);
+		if (p[1] != RFB_MAGIC1)
+			continue;
+
+		rfb_read(&p[2], sizeof(*hdr) - 2);
+		if (rfb_hdr_valid(hdr))
+			return;
+
+		rfb_errors++;
+	}
+}
+
+static int __ram_func rfb_decode(const struct rfb_rx *rx, u16 *dst)
+{
+	const struct rfb_hdr *hdr = &rx->hdr;
+	size_t count = hdr->w * hdr->h;
+
+	switch (hdr->type) {
+	case RFB_RECT_RAW:
+		if (hdr->len != count * 2)
+			return -1;
+		memcpy(dst, rx->data, hdr->len);
+		return count;
+	case RFB_RECT_RLE:
+		return rfb_decode_rle(rx->data, hdr->len, dst, count);
+	case RFB_RECT_LZ4:
+		return rfb_decode_lz4(rx->data, hdr->len, dst, count);
+	default:
+		return -1;
+	}
+}
+
+static void __ram_func rfb_core1_entry(void)
+{
+	const struct rfb_hdr *hdr;
+	struct rfb_rx *rx;
+	int buf = 0, n;
+	u16 *px;
+
+	for (;;) {
+		rx = &rx_slots[multicore_fifo_pop_blocking()];
+		hdr = &rx->hdr;
+
+		if (hdr->type == RFB_SYNC) {
+			ili9488_video_flush_wait();
+			multicore_fifo_push_blocking(rx - rx_slots);
+			continue;
+		}
+
+		/* the DMA of this buffer was waited for by the previous flush */
+		px = pix_bufs[buf];
+		n = rfb_decode(rx, px);
+		multicore_fifo_push_blocking(rx - rx_slots);
+
+		if (n != hdr->w * hdr->h) {
+			rfb_errors++;
+			continue;
+		}
+
+		ili9488_video_flush_async(hdr->x, hdr->y, hdr->x + hdr->w - 1,
+					  hdr->y + hdr->h - 1, px,
+					  n * sizeof(u16));
+		buf ^= 1;
+	}
+}
+
+/* Never returns, the panel belongs to the host from now on */
+void rfb_sink_run(void)
+{
+	struct rfb_hdr reply;
+	struct rfb_rx *rx;
+	int slot = 0, busy = 0;
+
+	pr_debug("rfb: waiting for the host, %lux%lu\n", ili9488_get_xres(),
+		 ili9488_get_yres());
+
+	multicore_launch_core1(rfb_core1_entry);
+
+	for (;;) {
+		if (busy == RFB_SLOTS) {
+			multicore_fifo_pop_blocking();
+			busy--;
+		}
+
+		rx = &rx_slots[slot];
+		rfb_read_hdr(&rx->hdr);
+		if (rx->hdr.len)
+			rfb_read(rx->data, rx->hdr.len);
+
+		multicore_fifo_push_blocking(slot);
+		busy++;
+		slot = (slot + 1) % RFB_SLOTS;
+
+		if (rx->hdr.type != RFB_SYNC)
+			continue;
+
+		/* core1 returns the slots in order, the sync one comes last */
+		while (busy) {
+			multicore_fifo_pop_blocking();
+			busy--;
+		}
+
+		/* the reply carries the number of dropped packets so far */
+		reply = rx->hdr;
+		reply.len = rfb_errors;
+		stdio_usb.out_chars((const char *)&reply, sizeof(reply));
+	}
+}
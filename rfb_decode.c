@@ -0,0 +1,118 @@
+// Copyright (c) 2026 embeddedboys developers
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+/*
+ * Rectangle decoders of the remote framebuffer sink, kept free of SDK
+ * headers so tools/rfb_check.c can run them on the host. Both return the
+ * number of pixels written to `dst`, at most `count`, or -1 on bad data.
+ */
+
+#include <string.h>
+
+#include "rfb.h"
+
+#define __ram_func __attribute__((section(".time_critical.rfb")))
+
+typedef uint16_t u16;
+typedef uint8_t u8;
+
+int __ram_func rfb_decode_rle(const u8 *src, size_t len, u16 *dst, size_t count)
+{
+	const u8 *end = src + len;
+	u16 *p = dst, *pend = dst + count;
+	u16 c;
+	int run;
+
+	while (src + 3 <= end) {
+		run = src[0] + 1;
+		c = src[1] | src[2] << 8;
+		src += 3;
+
+		if (p + run > pend)
+			return -1;
+
+		while (run--)
+			*p++ = c;
+	}
+
+	return p - dst;
+}
+
+static size_t __ram_func lz4_len(const u8 **src, const u8 *end, size_t len)
+{
+	u8 b;
+
+	if (len != 15)
+		return len;
+
+	do {
+		if (*src >= end)
+			break;
+		b = *(*src)++;
+		len += b;
+	} while (b == 255);
+
+	return len;
+}
+
+/* LZ4 block format, back references stay inside the rectangle */
+int __ram_func rfb_decode_lz4(const u8 *src, size_t len, u16 *dst, size_t count)
+{
+	const u8 *end = src + len;
+	u8 *op = (u8 *)dst, *ostart = op, *oend = op + count * 2;
+	const u8 *ref;
+	size_t n, off;
+	u8 token;
+
+	while (src < end) {
+		token = *src++;
+
+		n = lz4_len(&src, end, token >> 4);
+		if (n > end - src || n > oend - op)
+			return -1;
+		memcpy(op, src, n);
+		op += n;
+		src += n;
+
+		/* the last sequence has literals only */
+		if (src >= end)
+			break;
+
+		if (end - src < 2)
+			return -1;
+		off = src[0] | src[1] << 8;
+		src += 2;
+		if (!off || off > op - ostart)
+			return -1;
+
+		n = lz4_len(&src, end, token & 0xf) + 4;
+		if (n > oend - op)
+			return -1;
+
+		/* may overlap, byte by byte */
+		ref = op - off;
+		while (n--)
+			*op++ = *ref++;
+	}
+
+	return (op - ostart) / 2;
+}
@@ -0,0 +1,51 @@
+// Copyright (c) 2026 embeddedboys developers
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include "ili9488.h"
+#include "ft6236.h"
+#include "rotation.h"
+#include "halfres.h"
+
+void rotation_set(lv_disp_t *disp, uint8_t rotate)
+{
+	lv_disp_drv_t *drv = disp->driver;
+
+	rotate &= 3;
+	if (rotate == ili9488_get_rotation())
+		return;
+
+	/* the last flush has to land before the scan direction changes */
+	ili9488_video_flush_wait();
+
+	ili9488_set_rotation(rotate);
+	ft6236_set_dir(rotate);
+
+	/* re-layouts the screens and invalidates them */
+	drv->hor_res = ili9488_get_xres() >> halfres_get();
+	drv->ver_res = ili9488_get_yres() >> halfres_get();
+	lv_disp_drv_update(disp, drv);
+}
+
+uint8_t rotation_get(void)
+{
+	return ili9488_get_rotation();
+}
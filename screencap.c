@@ -0,0 +1,277 @@
+// Copyright (c) 2026 embeddedboys developers
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#define pr_fmt(fmt) "screencap: " fmt
+
+#include <stdio.h>
+#include <string.h>
+
+#include "pico/stdlib.h"
+#include "pico/stdio_usb.h"
+#include "tusb.h"
+
+#include "lvgl/lvgl.h"
+
+#include "ili9488.h"
+#include "screencap.h"
+
+#if SCREENCAP_ENABLED
+
+#define pr_debug printf
+
+#define ARRAY_SIZE(arr) (sizeof(arr) / sizeof(arr[0]))
+
+typedef unsigned int u32;
+typedef unsigned short u16;
+typedef unsigned char u8;
+
+#define SCAP_TILE_W    32
+#define SCAP_TILE_H    16
+#define SCAP_TILE_PX   (SCAP_TILE_W * SCAP_TILE_H)
+#define SCAP_TILES     (LCD_HOR_RES * LCD_VER_RES / SCAP_TILE_PX)
+#define SCAP_PKT_MAX   240 /* below the 256 bytes CDC TX fifo */
+#define SCAP_TICK_MS   5
+#define SCAP_BUDGET_US 1000 /* per tick, the render loop must not stall */
+
+struct screencap {
+	bool busy; /* a frame is being sent */
+	bool stream;
+	bool delta;
+	u16 frame;
+
+	u16 hor_res;
+	u16 ver_res;
+	u16 cols;
+
+	int tile; /* tile being sent, -1 before the first one */
+	u16 px_off; /* first pixel of the tile not sent yet */
+	u16 px[SCAP_TILE_PX];
+
+	/* tiles touched by the flush path, and the ones of this frame */
+	u32 dirty[(SCAP_TILES + 31) / 32];
+	u32 todo[(SCAP_TILES + 31) / 32];
+} g_scap;
+
+static inline bool scap_bit(const u32 *map, int i)
+{
+	return map[i / 32] & (1u << (i % 32));
+}
+
+static inline void put_u16(u8 *p, u16 v)
+{
+	p[0] = v;
+	p[1] = v >> 8;
+}
+
+/* never block, the caller retries on the next tick */
+static bool scap_room(size_t len)
+{
+	return tud_cdc_write_available() >= len;
+}
+
+static void scap_send(u8 *pkt, u8 type, size_t payload)
+{
+	pkt[0] = SCAP_MAGIC0;
+	pkt[1] = SCAP_MAGIC1;
+	pkt[2] = type;
+	pkt[3] = payload;
+	stdio_usb.out_chars((const char *)pkt, payload + 4);
+}
+
+/*
+ * Called from the flush path with the area being sent to the panel, only
+ * marks the tiles it covers. The pixels are read back from GRAM later.
+ */
+void __attribute__((section(".time_critical.screencap")))
+screencap_mark_dirty(int xs, int ys, int xe, int ye)
+{
+	struct screencap *sc = &g_scap;
+	int cols = ili9488_get_xres() / SCAP_TILE_W; /* follows rotation */
+	int x, y, i;
+
+	if (!sc->stream)
+		return;
+
+	for (y = ys / SCAP_TILE_H; y <= ye / SCAP_TILE_H; y++) {
+		for (x = xs / SCAP_TILE_W; x <= xe / SCAP_TILE_W; x++) {
+			i = y * cols + x;
+			sc->dirty[i / 32] |= 1u << (i % 32);
+		}
+	}
+}
+
+static bool scap_frame_begin(struct screencap *sc, bool delta)
+{
+	u8 pkt[4 + 7];
+
+	if (!scap_room(sizeof(pkt)))
+		return false;
+
+	/* the host keeps nothing across a rotation */
+	if (sc->hor_res != lv_disp_get_hor_res(NULL))
+		delta = false;
+
+	sc->hor_res = lv_disp_get_hor_res(NULL);
+	sc->ver_res = lv_disp_get_ver_res(NULL);
+	sc->cols = sc->hor_res / SCAP_TILE_W;
+
+	if (delta) {
+		memcpy(sc->todo, sc->dirty, sizeof(sc->todo));
+	} else {
+		memset(sc->todo, 0xff, sizeof(sc->todo));
+	}
+	memset(sc->dirty, 0, sizeof(sc->dirty));
+
+	put_u16(&pkt[4], ++sc->frame);
+	put_u16(&pkt[6], sc->hor_res);
+	put_u16(&pkt[8], sc->ver_res);
+	pkt[10] = delta;
+	scap_send(pkt, SCAP_FRAME_BEGIN, 7);
+
+	sc->busy = true;
+	sc->delta = delta;
+	sc->tile = -1;
+	sc->px_off = SCAP_TILE_PX;
+	return true;
+}
+
+static bool scap_frame_end(struct screencap *sc)
+{
+	u8 pkt[4 + 2];
+
+	if (!scap_room(sizeof(pkt)))
+		return false;
+
+	put_u16(&pkt[4], sc->frame);
+	scap_send(pkt, SCAP_FRAME_END, 2);
+
+	sc->busy = false;
+	return true;
+}
+
+/* RLE encode the rest of the current tile into one packet */
+static void scap_send_tile_part(struct screencap *sc)
+{
+	u8 pkt[SCAP_PKT_MAX];
+	u8 *p = &pkt[4 + 8];
+	u16 x = (sc->tile % sc->cols) * SCAP_TILE_W;
+	u16 y = (sc->tile / sc->cols) * SCAP_TILE_H;
+	u16 i = sc->px_off, run;
+
+	put_u16(&pkt[4], x);
+	put_u16(&pkt[6], y);
+	pkt[8] = SCAP_TILE_W;
+	pkt[9] = SCAP_TILE_H;
+	put_u16(&pkt[10], sc->px_off);
+
+	while (i < SCAP_TILE_PX && p + 3 <= pkt + sizeof(pkt)) {
+		for (run = 1; i + run < SCAP_TILE_PX && run < 256; run++)
+			if (sc->px[i + run] != sc->px[i])
+				break;
+
+		p[0] = run - 1;
+		p[1] = sc->px[i];
+		p[2] = sc->px[i] >> 8;
+		p += 3;
+		i += run;
+	}
+
+	sc->px_off = i;
+	scap_send(pkt, SCAP_TILE_DATA, p - pkt - 4);
+}
+
+/* returns false when the CDC fifo is full */
+static bool scap_step(struct screencap *sc)
+{
+	int x, y;
+
+	if (sc->px_off == SCAP_TILE_PX) {
+		/* next tile of this frame */
+		do {
+			sc->tile++;
+		} while (sc->tile < SCAP_TILES && !scap_bit(sc->todo, sc->tile));
+
+		if (sc->tile >= SCAP_TILES)
+			return scap_frame_end(sc);
+
+		x = (sc->tile % sc->cols) * SCAP_TILE_W;
+		y = (sc->tile / sc->cols) * SCAP_TILE_H;
+		ili9488_read_gram(x, y, x + SCAP_TILE_W - 1, y + SCAP_TILE_H - 1,
+				  sc->px);
+		sc->px_off = 0;
+	}
+
+	if (!scap_room(SCAP_PKT_MAX))
+		return false;
+
+	scap_send_tile_part(sc);
+	return true;
+}
+
+static bool scap_dirty(struct screencap *sc)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(sc->dirty); i++)
+		if (sc->dirty[i])
+			return true;
+
+	return false;
+}
+
+static void screencap_timer_cb(lv_timer_t *timer)
+{
+	struct screencap *sc = &g_scap;
+	u32 start = time_us_32();
+	int c;
+
+	while ((c = getchar_timeout_us(0)) != PICO_ERROR_TIMEOUT) {
+		if (c == SCAP_CMD_SHOT && !sc->busy) {
+			scap_frame_begin(sc, false);
+		} else if (c == SCAP_CMD_STREAM) {
+			sc->stream = !sc->stream;
+			/* start over with a full frame */
+			if (sc->stream && !sc->busy)
+				scap_frame_begin(sc, false);
+		}
+	}
+
+	if (!stdio_usb_connected()) {
+		sc->busy = false;
+		sc->stream = false;
+		return;
+	}
+
+	if (!sc->busy && sc->stream && scap_dirty(sc))
+		scap_frame_begin(sc, true);
+
+	while (sc->busy && time_us_32() - start < SCAP_BUDGET_US)
+		if (!scap_step(sc))
+			break;
+}
+
+void screencap_init(void)
+{
+	memset(&g_scap, 0, sizeof(g_scap));
+	lv_timer_create(screencap_timer_cb, SCAP_TICK_MS, NULL);
+}
+
+#endif
@@ -0,0 +1,69 @@
+# Copyright (c) 2024 embeddedboys developers
+
+# Permission is hereby granted, free of charge, to any person obtaining
+# a copy of this software and associated documentation files (the
+# "Software"), to deal in the Software without restriction, including
+# without limitation the rights to use, copy, modify, merge, publish,
+# distribute, sublicense, and/or sell copies of the Software, and to
+# permit persons to whom the Software is furnished to do so, subject to
+# the following conditions:
+
+# The above copyright notice and this permission notice shall be
+# included in all copies or substantial portions of the Software.
+
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+# MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+# NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+# LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+# OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+# WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+# SRAM hot-path placement
+#
+# The pico-sdk linker scripts leave everything that is excluded from the flash
+# .text output section to the .data section, which crt0 copies into SRAM. This
+# generates a copy of the default linker script with the objects listed below
+# added to that exclude list, so their code runs from SRAM instead of XIP.
+#
+# Placement is per object file, the list was picked by profiling
+# lv_demo_benchmark() and lv_demo_widgets(). Keep an eye on the report
+# printed by sram_report.cmake when adding entries, SRAM is shared with
+# the draw buffer and the LVGL heap.
+
+set(SRAM_HOT_OBJECTS
+    # LVGL software renderer
+    *liblvgl.a:lv_draw_sw_blend.c.obj
+    *liblvgl.a:lv_draw_sw_rect.c.obj
+    *liblvgl.a:lv_draw_sw_letter.c.obj
+    *liblvgl.a:lv_draw_sw_img.c.obj
+    *liblvgl.a:lv_draw_mask.c.obj
+    *liblvgl.a:lv_color.c.obj
+    *liblvgl.a:lv_area.c.obj
+    *liblvgl.a:lv_font_fmt_txt.c.obj
+
+    # touch driver path, polled every LV_INDEV_DEF_READ_PERIOD
+    *ft6236.c.obj
+    *hardware_i2c/i2c.c.obj
+)
+
+function(sram_hot_path_setup TARGET)
+    if(${PICO_BOARD} STREQUAL "pico" OR ${PICO_PLATFORM} STREQUAL "rp2040")
+        set(MEMMAP_DEFAULT ${PICO_SDK_PATH}/src/rp2_common/pico_crt0/rp2040/memmap_default.ld)
+    elseif(${PICO_BOARD} STREQUAL "pico2" OR ${PICO_PLATFORM} STREQUAL "rp2350")
+        set(MEMMAP_DEFAULT ${PICO_SDK_PATH}/src/rp2_common/pico_crt0/rp2350/memmap_default.ld)
+    endif()
+
+    file(READ ${MEMMAP_DEFAULT} MEMMAP)
+    list(JOIN SRAM_HOT_OBJECTS " " HOT_OBJECTS)
+
+    string(REGEX REPLACE "EXCLUDE_FILE\\(([^)]*)\\) \\.text\\*"
+           "EXCLUDE_FILE(\\1 ${HOT_OBJECTS}) .text*" MEMMAP_HOT "${MEMMAP}")
+    if("${MEMMAP_HOT}" STREQUAL "${MEMMAP}")
+        message(FATAL_ERROR "ERROR: no .text EXCLUDE_FILE rule found in ${MEMMAP_DEFAULT}")
+    endif()
+
+    set(MEMMAP_HOT_LD ${CMAKE_BINARY_DIR}/memmap_sram_hot.ld)
+    file(WRITE ${MEMMAP_HOT_LD} "${MEMMAP_HOT}")
+    pico_set_linker_script(${TARGET} ${MEMMAP_HOT_LD})
+endfunction()
@@ -0,0 +1,78 @@
+# Copyright (c) 2024 embeddedboys developers
+
+# Permission is hereby granted, free of charge, to any person obtaining
+# a copy of this software and associated documentation files (the
+# "Software"), to deal in the Software without restriction, including
+# without limitation the rights to use, copy, modify, merge, publish,
+# distribute, sublicense, and/or sell copies of the Software, and to
+# permit persons to whom the Software is furnished to do so, subject to
+# the following conditions:
+
+# The above copyright notice and this permission notice shall be
+# included in all copies or substantial portions of the Software.
+
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+# MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+# NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+# LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+# OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+# WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+# Post-build SRAM placement report, run in script mode:
+#
+#   cmake -DELF=<file.elf> -DNM=<nm> -DSRAM_CODE_BUDGET=<bytes>
+#         -DREPORT=<file.txt> -P sram_report.cmake
+#
+# Lists every function placed in SRAM and every LVGL/driver function still
+# executed from XIP flash, with their sizes against the SRAM code budget.
+
+set(SRAM_BASE 536870912)   # 0x20000000
+set(FLASH_BASE 268435456)  # 0x10000000
+set(FLASH_PATTERN "^_?(lv_|ili9488_|ft6236_|i80_|mem_ops_|backlight_)")
+
+execute_process(
+    COMMAND ${NM} -S -t d --size-sort ${ELF}
+    OUTPUT_VARIABLE NM_OUTPUT
+    RESULT_VARIABLE NM_RESULT
+)
+if(NOT NM_RESULT EQUAL 0)
+    message(FATAL_ERROR "ERROR: ${NM} failed on ${ELF}")
+endif()
+
+string(REPLACE "\n" ";" NM_LINES "${NM_OUTPUT}")
+
+set(SRAM_TOTAL 0)
+set(FLASH_TOTAL 0)
+set(SRAM_LIST "")
+set(FLASH_LIST "")
+
+foreach(LINE ${NM_LINES})
+    if(NOT LINE MATCHES "^([0-9]+) ([0-9]+) [Tt] (.+)$")
+        continue()
+    endif()
+    set(ADDR ${CMAKE_MATCH_1})
+    set(NAME ${CMAKE_MATCH_3})
+    math(EXPR SIZE "${CMAKE_MATCH_2}") # drops the zero padding of nm
+
+    if(ADDR GREATER_EQUAL SRAM_BASE)
+        math(EXPR SRAM_TOTAL "${SRAM_TOTAL} + ${SIZE}")
+        # nm sorts ascending, prepend to get the biggest first
+        string(PREPEND SRAM_LIST "    ${SIZE}\t${NAME}\n")
+    elseif(ADDR GREATER_EQUAL FLASH_BASE AND NAME MATCHES "${FLASH_PATTERN}")
+        math(EXPR FLASH_TOTAL "${FLASH_TOTAL} + ${SIZE}")
+        string(PREPEND FLASH_LIST "    ${SIZE}\t${NAME}\n")
+    endif()
+endforeach()
+
+set(REPORT_TEXT "SRAM code : ${SRAM_TOTAL} / ${SRAM_CODE_BUDGET} bytes\n")
+string(APPEND REPORT_TEXT "Flash (LVGL and drivers) : ${FLASH_TOTAL} bytes\n\n")
+string(APPEND REPORT_TEXT "Functions in SRAM (size, name):\n${SRAM_LIST}\n")
+string(APPEND REPORT_TEXT "LVGL and driver functions in XIP flash (size, name):\n${FLASH_LIST}")
+file(WRITE ${REPORT} "${REPORT_TEXT}")
+
+message(STATUS "SRAM code: ${SRAM_TOTAL} / ${SRAM_CODE_BUDGET} bytes, LVGL and drivers left in flash: ${FLASH_TOTAL} bytes")
+message(STATUS "Full placement report: ${REPORT}")
+if(SRAM_TOTAL GREATER SRAM_CODE_BUDGET)
+    message(WARNING "SRAM code exceeds the budget of ${SRAM_CODE_BUDGET} bytes")
+endif()
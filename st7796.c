@@ -0,0 +1,80 @@
+// Copyright (c) 2026 embeddedboys developers
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include <stdint.h>
+
+#include "ili9488.h"
+#include "lcd_seq.h"
+#include "lcd_panel.h"
+
+/* Sitronix ST7796S, 320x480, ILI9488 pin compatible modules */
+
+static const uint8_t st7796_madctl[] = {
+	[LCD_ROTATE_0] = MX | BGR,
+	[LCD_ROTATE_90] = MV | BGR,
+	[LCD_ROTATE_180] = MY | BGR,
+	[LCD_ROTATE_270] = MX | MY | MV | BGR,
+};
+
+static const uint32_t st7796_init_seq[] = {
+	LCD_SEQ_CMD(0x11), // Sleep Out
+	LCD_SEQ_DELAY_MS(120),
+
+	LCD_SEQ_REG(0xF0, 0xC3), // Command Set Control, enable part 1
+	LCD_SEQ_REG(0xF0, 0x96), // and part 2
+
+	LCD_SEQ_REG(0xB4, 0x01), // Display Inversion Control, 1-dot
+	LCD_SEQ_REG(0xB6, 0x80, 0x02, 0x3B), // Display Function Control
+	LCD_SEQ_REG(0xE8, 0x40, 0x8A, 0x00, 0x00, 0x29, 0x19, 0xA5,
+		    0x33), // Display Output Ctrl Adjust
+	LCD_SEQ_REG(0xC1, 0x06), // Power Control 2
+	LCD_SEQ_REG(0xC2, 0xA7), // Power Control 3
+	LCD_SEQ_REG(0xC5, 0x18), // VCOM Control
+	LCD_SEQ_DELAY_MS(120),
+
+	// Positive Gamma Control
+	LCD_SEQ_REG(0xE0, 0xF0, 0x09, 0x0B, 0x06, 0x04, 0x15, 0x2F, 0x54,
+		    0x42, 0x3C, 0x17, 0x14, 0x18, 0x1B),
+	// Negative Gamma Control
+	LCD_SEQ_REG(0xE1, 0xE0, 0x09, 0x0B, 0x06, 0x04, 0x03, 0x2B, 0x43,
+		    0x42, 0x3B, 0x16, 0x14, 0x17, 0x1B),
+	LCD_SEQ_DELAY_MS(120),
+
+	LCD_SEQ_REG(0xF0, 0x3C), // Command Set Control, disable part 1
+	LCD_SEQ_REG(0xF0, 0x69), // and part 2
+	LCD_SEQ_DELAY_MS(120),
+
+	LCD_SEQ_CMD(0x29), // Display on
+};
+
+const struct lcd_controller lcd_st7796 = {
+	.name = "st7796",
+	.type = LCD_CTRL_ST7796,
+	.id = 0x007796,
+	.xres = 320,
+	.yres = 480,
+	.madctl = st7796_madctl,
+	.init_seq = st7796_init_seq,
+	.init_len = sizeof(st7796_init_seq) / sizeof(st7796_init_seq[0]),
+	.pixfmts = LCD_PIXFMT_RGB565 | LCD_PIXFMT_RGB666 | LCD_PIXFMT_RGB888,
+	.wr_khz_max = 15000, /* tWC 66 ns */
+};
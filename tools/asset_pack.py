@@ -0,0 +1,371 @@
+#!/usr/bin/env python3
+# Copyright (c) 2026 embeddedboys developers
+# SPDX-License-Identifier: MIT
+#
+# Build time asset converter, run by asset_pack.cmake. The formats are
+# described in include/asset.h and decoded by asset.c.
+#
+#   asset_pack.py font  fsex_16.c  out.c  fsex_16_rle
+#   asset_pack.py image logo.png   out.c  img_logo
+#   asset_pack.py index asset_list.c asset_list.h --fonts fsex_16_rle --images img_logo
+#
+# Fonts are the C files written by lv_font_conv (bitmap_format 0), their
+# glyph bitmaps are XORed with the row above and RLE coded, everything else
+# is kept as is.
+# Images are quantized to a palette of at most 256 RGB565 colours and every
+# line is RLE coded on its own, so any line can be decoded directly.
+
+import argparse
+import re
+import sys
+
+HEADER = """\
+/* Generated by tools/asset_pack.py from %s, do not edit. */
+
+#include "lvgl/lvgl.h"
+#include "asset.h"
+"""
+
+
+def c_array(data, per_line=12):
+    lines = []
+    for i in range(0, len(data), per_line):
+        lines.append("    " + ", ".join("0x%02x" % b for b in data[i:i + per_line]) + ",")
+    return "\n".join(lines)
+
+
+def c_array16(data, per_line=8):
+    lines = []
+    for i in range(0, len(data), per_line):
+        lines.append("    " + ", ".join("0x%04x" % v for v in data[i:i + per_line]) + ",")
+    return "\n".join(lines)
+
+
+def c_array32(data, per_line=8):
+    lines = []
+    for i in range(0, len(data), per_line):
+        lines.append("    " + ", ".join("%d" % v for v in data[i:i + per_line]) + ",")
+    return "\n".join(lines)
+
+
+def section(src, start, end):
+    i = src.index(start)
+    return src[i:src.index(end, i)]
+
+
+def field(src, name):
+    m = re.search(r"\.%s\s*=\s*([^,\n]+)" % name, src)
+    if not m:
+        sys.exit("asset_pack: .%s not found" % name)
+    return m.group(1).strip()
+
+
+def glyph_pixels(bitmap, index, count, bpp):
+    mask = (1 << bpp) - 1
+    for i in range(count):
+        bit = i * bpp
+        yield bitmap[index + bit // 8] >> (8 - bpp - bit % 8) & mask
+
+
+def xor_rows(pixels, w):
+    """Every pixel XOR the one above, vertical strokes turn into zero runs."""
+    return [pixels[i] ^ (pixels[i - w] if i >= w else 0) for i in range(len(pixels))]
+
+
+def unxor_rows(pixels, w):
+    out = list(pixels)
+    for i in range(w, len(out)):
+        out[i] ^= out[i - w]
+    return out
+
+
+def rle_glyph(pixels):
+    """
+    1nnnvvvv repeats v n + 3 times, n == 7 takes the count - 10 from the
+    next byte. 0nnnnnnn is followed by n + 1 literal pixels, two per byte.
+    """
+    out = bytearray()
+    lit = []
+
+    def flush():
+        while lit:
+            chunk = lit[:128]
+            del lit[:128]
+            out.append(len(chunk) - 1)
+            chunk = chunk + [0] * (len(chunk) & 1)
+            out.extend(chunk[i] << 4 | chunk[i + 1] for i in range(0, len(chunk), 2))
+
+    i = 0
+    while i < len(pixels):
+        run = 1
+        while i + run < len(pixels) and run < 265 and pixels[i + run] == pixels[i]:
+            run += 1
+        if run < 3:
+            lit.extend(pixels[i:i + run])
+        else:
+            flush()
+            if run < 10:
+                out.append(0x80 | (run - 3) << 4 | pixels[i])
+            else:
+                out += bytes((0xF0 | pixels[i], run - 10))
+        i += run
+    flush()
+    return out
+
+
+def unrle_glyph(data, count):
+    """Reference decoder, mirrors asset_glyph_decode()."""
+    px = []
+    i = 0
+    while len(px) < count:
+        t = data[i]
+        i += 1
+        if t & 0x80:
+            n = (t >> 4) & 7
+            if n == 7:
+                n = data[i] + 10
+                i += 1
+            else:
+                n += 3
+            px += [t & 0xF] * n
+        else:
+            n = t + 1
+            for k in range(n):
+                px.append(data[i + k // 2] >> (0 if k & 1 else 4) & 0xF)
+            i += (n + 1) // 2
+    return px
+
+
+def pack_font(src_path, out, name):
+    src = open(src_path).read()
+
+    if field(src, "bitmap_format") != "0":
+        sys.exit("asset_pack: %s is already compressed" % src_path)
+    bpp = int(field(src, "bpp"))
+    if bpp not in (1, 2, 4):
+        sys.exit("asset_pack: %d bpp is not supported" % bpp)
+
+    bitmap = bytes(int(v, 16) for v in re.findall(
+        r"0x[0-9a-fA-F]+", section(src, "glyph_bitmap[] = {", "};")))
+    dsc_re = re.compile(r"\{\.bitmap_index = (\d+), \.adv_w = (\d+), \.box_w = (\d+), "
+                        r"\.box_h = (\d+), \.ofs_x = (-?\d+), \.ofs_y = (-?\d+)\}")
+    glyphs = [tuple(int(v) for v in m) for m in dsc_re.findall(
+        section(src, "glyph_dsc[] = {", "};"))]
+
+    packed = bytearray()
+    dsc = []
+    raw_size = max_glyph = 0
+    for index, adv_w, box_w, box_h, ofs_x, ofs_y in glyphs:
+        count = box_w * box_h
+        size = (count * bpp + 7) // 8
+        raw_size += size
+        max_glyph = max(max_glyph, size)
+        dsc.append("    {.bitmap_index = %d, .adv_w = %d, .box_w = %d, .box_h = %d, "
+                   ".ofs_x = %d, .ofs_y = %d}," % (len(packed), adv_w, box_w, box_h,
+                                                    ofs_x, ofs_y))
+        pixels = list(glyph_pixels(bitmap, index, count, bpp))
+        rle = rle_glyph(xor_rows(pixels, box_w))
+        assert unxor_rows(unrle_glyph(rle, count), box_w) == pixels
+        packed += rle
+
+    # cmaps and kerning tables are taken over verbatim
+    mapping = section(src, "/*---------------------\n *  CHARACTER MAPPING",
+                      "/*--------------------\n *  ALL CUSTOM DATA")
+
+    with open(out, "w") as f:
+        f.write(HEADER % src_path.split("/")[-1])
+        f.write("\n/* %d glyphs, %d bytes raw, %d bytes packed */\n" %
+                (len(glyphs), raw_size, len(packed)))
+        f.write("static const uint8_t glyph_bitmap[] = {\n%s\n};\n\n" % c_array(packed))
+        f.write("static const lv_font_fmt_txt_glyph_dsc_t glyph_dsc[] = {\n%s\n};\n\n" %
+                "\n".join(dsc))
+        f.write(mapping)
+        f.write("""static lv_font_fmt_txt_glyph_cache_t cache;
+
+static const lv_font_fmt_txt_dsc_t font_dsc = {
+    .glyph_bitmap = glyph_bitmap,
+    .glyph_dsc = glyph_dsc,
+    .cmaps = cmaps,
+    .kern_dsc = %(kern_dsc)s,
+    .kern_scale = %(kern_scale)s,
+    .cmap_num = %(cmap_num)s,
+    .bpp = %(bpp)d,
+    .kern_classes = %(kern_classes)s,
+    .bitmap_format = 0, /* decoded by asset_font_get_bitmap() */
+    .cache = &cache
+};
+
+static const struct asset_font asset = {
+    .glyph_cnt = %(glyph_cnt)d,
+    .max_glyph = %(max_glyph)d,
+    .raw_size = %(raw_size)d,
+    .packed_size = %(packed_size)d,
+};
+
+const lv_font_t %(name)s = {
+    .get_glyph_dsc = lv_font_get_glyph_dsc_fmt_txt,
+    .get_glyph_bitmap = asset_font_get_bitmap,
+    .line_height = %(line_height)s,
+    .base_line = %(base_line)s,
+    .subpx = LV_FONT_SUBPX_NONE,
+    .underline_position = %(underline_position)s,
+    .underline_thickness = %(underline_thickness)s,
+    .dsc = &font_dsc,
+    .fallback = NULL,
+    .user_data = (void *)&asset
+};
+""" % {
+            "name": name,
+            "bpp": bpp,
+            "kern_dsc": field(src, "kern_dsc"),
+            "kern_scale": field(src, "kern_scale"),
+            "cmap_num": field(src, "cmap_num"),
+            "kern_classes": field(src, "kern_classes"),
+            "line_height": field(src, "line_height"),
+            "base_line": field(src, "base_line"),
+            "underline_position": field(src, "underline_position"),
+            "underline_thickness": field(src, "underline_thickness"),
+            "glyph_cnt": len(glyphs),
+            "max_glyph": max_glyph,
+            "raw_size": raw_size,
+            "packed_size": len(packed),
+        })
+
+
+def load_image(path):
+    """Returns width, height and a list of RGB565 pixels."""
+    if path.endswith(".ppm"):
+        data = open(path, "rb").read()
+        fields = data.split(maxsplit=4)
+        if fields[0] != b"P6" or fields[3] != b"255":
+            sys.exit("asset_pack: only 8-bit binary PPM is supported")
+        w, h, rgb = int(fields[1]), int(fields[2]), fields[4]
+    else:
+        try:
+            from PIL import Image
+        except ImportError:
+            sys.exit("asset_pack: Pillow is needed for %s, or convert it to PPM" % path)
+        img = Image.open(path).convert("RGB")
+        w, h = img.size
+        rgb = img.tobytes()
+
+    px = [(rgb[i] & 0xF8) << 8 | (rgb[i + 1] & 0xFC) << 3 | rgb[i + 2] >> 3
+          for i in range(0, w * h * 3, 3)]
+    return w, h, px
+
+
+def quantize(w, h, px):
+    try:
+        from PIL import Image
+    except ImportError:
+        sys.exit("asset_pack: Pillow is needed to reduce the colours")
+    rgb = bytearray()
+    for c in px:
+        rgb += bytes(((c >> 8) & 0xF8, (c >> 3) & 0xFC, (c << 3) & 0xF8))
+    img = Image.frombytes("RGB", (w, h), bytes(rgb))
+    rgb = img.quantize(256, dither=Image.Dither.NONE).convert("RGB").tobytes()
+    return [(rgb[i] & 0xF8) << 8 | (rgb[i + 1] & 0xFC) << 3 | rgb[i + 2] >> 3
+            for i in range(0, w * h * 3, 3)]
+
+
+def pack_image(src_path, out, name):
+    w, h, px = load_image(src_path)
+
+    palette = sorted(set(px))
+    if len(palette) > 256:
+        print("asset_pack: %s has %d colours, reducing to 256" % (src_path, len(palette)))
+        px = quantize(w, h, px)
+        palette = sorted(set(px))
+    index = {c: i for i, c in enumerate(palette)}
+
+    runs = bytearray()
+    line_ofs = []
+    for y in range(h):
+        line_ofs.append(len(runs))
+        line = px[y * w:(y + 1) * w]
+        x = 0
+        while x < w:
+            run = 1
+            while x + run < w and run < 256 and line[x + run] == line[x]:
+                run += 1
+            runs += bytes((run - 1, index[line[x]]))
+            x += run
+
+    packed_size = len(palette) * 2 + len(line_ofs) * 4 + len(runs)
+
+    with open(out, "w") as f:
+        f.write(HEADER % src_path.split("/")[-1])
+        f.write("\n/* %dx%d, %d colours, %d bytes raw, %d bytes packed */\n" %
+                (w, h, len(palette), w * h * 2, packed_size))
+        f.write("static const uint16_t palette[] = {\n%s\n};\n\n" % c_array16(palette))
+        f.write("static const uint32_t line_ofs[] = {\n%s\n};\n\n" % c_array32(line_ofs))
+        f.write("static const uint8_t runs[] = {\n%s\n};\n\n" % c_array(runs))
+        f.write("""static const struct asset_img asset = {
+    .pal = palette,
+    .line_ofs = line_ofs,
+    .runs = runs,
+    .pal_cnt = %(pal_cnt)d,
+    .raw_size = %(raw_size)d,
+    .packed_size = %(packed_size)d,
+};
+
+const lv_img_dsc_t %(name)s = {
+    .header.cf = ASSET_IMG_CF,
+    .header.always_zero = 0,
+    .header.w = %(w)d,
+    .header.h = %(h)d,
+    .data_size = sizeof(asset),
+    .data = (const uint8_t *)&asset,
+};
+""" % {"name": name, "pal_cnt": len(palette), "raw_size": w * h * 2,
+       "packed_size": packed_size, "w": w, "h": h})
+
+
+def pack_index(out_c, out_h, fonts, images):
+    with open(out_h, "w") as f:
+        f.write("/* Generated by tools/asset_pack.py, do not edit. */\n\n")
+        f.write("#ifndef __ASSET_LIST_H\n#define __ASSET_LIST_H\n\n#include \"lvgl/lvgl.h\"\n\n")
+        for name in fonts:
+            f.write("LV_FONT_DECLARE(%s);\n" % name)
+        for name in images:
+            f.write("LV_IMG_DECLARE(%s);\n" % name)
+        f.write("\n#endif\n")
+
+    with open(out_c, "w") as f:
+        f.write(HEADER % "the asset lists")
+        f.write("#include \"asset_list.h\"\n\n")
+        f.write("const lv_font_t *const asset_fonts[] = {\n")
+        f.write("".join("    &%s,\n" % n for n in fonts) + "    NULL,\n};\n\n")
+        f.write("const char *const asset_font_names[] = {\n")
+        f.write("".join("    \"%s\",\n" % n for n in fonts) + "    NULL,\n};\n\n")
+        f.write("const lv_img_dsc_t *const asset_images[] = {\n")
+        f.write("".join("    &%s,\n" % n for n in images) + "    NULL,\n};\n\n")
+        f.write("const char *const asset_image_names[] = {\n")
+        f.write("".join("    \"%s\",\n" % n for n in images) + "    NULL,\n};\n")
+
+
+def main():
+    ap = argparse.ArgumentParser(description="compress fonts and images")
+    sub = ap.add_subparsers(dest="cmd", required=True)
+    for cmd in ("font", "image"):
+        p = sub.add_parser(cmd)
+        p.add_argument("src")
+        p.add_argument("out")
+        p.add_argument("name")
+    p = sub.add_parser("index")
+    p.add_argument("out_c")
+    p.add_argument("out_h")
+    p.add_argument("--fonts", nargs="*", default=[])
+    p.add_argument("--images", nargs="*", default=[])
+    args = ap.parse_args()
+
+    if args.cmd == "font":
+        pack_font(args.src, args.out, args.name)
+    elif args.cmd == "image":
+        pack_image(args.src, args.out, args.name)
+    else:
+        pack_index(args.out_c, args.out_h, args.fonts, args.images)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,123 @@
+// Copyright (c) 2026 embeddedboys developers
+// SPDX-License-Identifier: MIT
+//
+// Host run of the rfb.c rectangle decoders against a sender stream.
+//
+//   cc -O2 -Iinclude -o rfb_check tools/rfb_check.c
+//
+//   rfb_check [-w 480] [-h 320] stream.bin > frames.bin
+//   rfb_send.py --check --decoder ./rfb_check --pattern -n 10
+//
+// The stream is what rfb_send.py --dump writes, or stdin without a file.
+// At every sync the framebuffer goes to stdout as little endian RGB565,
+// rfb_send.py compares it with its own reference decoder. Any packet the
+// firmware would drop is reported and fails the run.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../rfb_decode.c"
+
+static uint8_t payload[RFB_RX_SIZE];
+static uint16_t px[RFB_BUF_PX];
+
+static int rect_decode(const struct rfb_hdr *hdr, size_t count)
+{
+	switch (hdr->type) {
+	case RFB_RECT_RAW:
+		if (hdr->len != count * 2)
+			return -1;
+		memcpy(px, payload, hdr->len);
+		return count;
+	case RFB_RECT_RLE:
+		return rfb_decode_rle(payload, hdr->len, px, count);
+	case RFB_RECT_LZ4:
+		return rfb_decode_lz4(payload, hdr->len, px, count);
+	default:
+		return -1;
+	}
+}
+
+static void usage(const char *prog)
+{
+	fprintf(stderr, "usage: %s [-w width] [-h height] [stream]\n", prog);
+	exit(1);
+}
+
+int main(int argc, char **argv)
+{
+	int width = 480, height = 320, opt, n, y;
+	int frames = 0, rects = 0, errors = 0;
+	struct rfb_hdr hdr;
+	uint16_t *fb;
+	FILE *f = stdin;
+
+	while ((opt = getopt(argc, argv, "w:h:")) != -1) {
+		switch (opt) {
+		case 'w':
+			width = atoi(optarg);
+			break;
+		case 'h':
+			height = atoi(optarg);
+			break;
+		default:
+			usage(argv[0]);
+		}
+	}
+
+	if (optind < argc) {
+		f = fopen(argv[optind], "rb");
+		if (!f) {
+			perror(argv[optind]);
+			return 1;
+		}
+	}
+
+	fb = calloc(width * height, sizeof(*fb));
+	if (!fb)
+		return 1;
+
+	while (fread(&hdr, sizeof(hdr), 1, f) == 1) {
+		if (hdr.magic[0] != RFB_MAGIC0 || hdr.magic[1] != RFB_MAGIC1) {
+			fprintf(stderr, "lost sync after %d rects\n", rects);
+			return 1;
+		}
+		if (hdr.len > RFB_RX_SIZE ||
+		    fread(payload, 1, hdr.len, f) != hdr.len) {
+			fprintf(stderr, "bad payload of %u bytes\n", hdr.len);
+			return 1;
+		}
+
+		if (hdr.type == RFB_SYNC) {
+			fwrite(fb, sizeof(*fb), width * height, stdout);
+			frames++;
+			continue;
+		}
+
+		rects++;
+		if (!hdr.w || !hdr.h || hdr.w * hdr.h > RFB_BUF_PX ||
+		    hdr.x + hdr.w > width || hdr.y + hdr.h > height) {
+			fprintf(stderr, "rect %d out of bounds\n", rects);
+			errors++;
+			continue;
+		}
+
+		n = rect_decode(&hdr, hdr.w * hdr.h);
+		if (n != hdr.w * hdr.h) {
+			fprintf(stderr, "rect %d type %u: %d of %d pixels\n",
+				rects, hdr.type, n, hdr.w * hdr.h);
+			errors++;
+			continue;
+		}
+
+		for (y = 0; y < hdr.h; y++)
+			memcpy(&fb[(hdr.y + y) * width + hdr.x], &px[y * hdr.w],
+			       hdr.w * sizeof(*fb));
+	}
+
+	fprintf(stderr, "%d frames, %d rects, %d errors\n", frames, rects,
+		errors);
+	return errors ? 1 : 0;
+}
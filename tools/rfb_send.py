@@ -0,0 +1,289 @@
+#!/usr/bin/env python3
+# Copyright (c) 2026 embeddedboys developers
+# SPDX-License-Identifier: MIT
+#
+# Sender for the remote framebuffer sink, see rfb.c and include/rfb.h.
+#
+#   rfb_send.py /dev/ttyACM0 image.ppm          show a picture
+#   rfb_send.py /dev/ttyACM0 --pattern -n 300   animated test pattern
+#   rfb_send.py --dump out.bin --pattern -n 10  write the stream to a file
+#   rfb_send.py --check --pattern -n 10         decode the stream back with
+#                                               the reference decoder
+#   rfb_send.py --check --decoder ./rfb_check --pattern -n 10
+#                                               and with the firmware
+#                                               decoders, see rfb_check.c
+#
+# Every band is sent as raw, RLE or LZ4, whichever is the smallest.
+
+import argparse
+import struct
+import subprocess
+import sys
+import time
+
+RFB_MAGIC = b"RF"
+RFB_BUF_PX = 4096
+RFB_RX_SIZE = RFB_BUF_PX * 2
+
+RFB_RECT_RAW = 1
+RFB_RECT_RLE = 2
+RFB_RECT_LZ4 = 3
+RFB_SYNC = 4
+
+HDR = struct.Struct("<2sBBHHHHH")
+
+
+def rle_encode(px):
+    out = bytearray()
+    i = 0
+    while i < len(px):
+        run = 1
+        while i + run < len(px) and run < 256 and px[i + run] == px[i]:
+            run += 1
+        out += bytes((run - 1, px[i] & 0xFF, px[i] >> 8))
+        i += run
+    return bytes(out)
+
+
+def rle_decode(data):
+    px = []
+    for i in range(0, len(data) - 2, 3):
+        px += [data[i + 1] | data[i + 2] << 8] * (data[i] + 1)
+    return px
+
+
+def lz4_put_len(out, n):
+    n -= 15
+    while n >= 255:
+        out.append(255)
+        n -= 255
+    out.append(n)
+
+
+def lz4_encode(src):
+    """Greedy LZ4 block compressor, enough to exercise the decoder."""
+    out = bytearray()
+    table = {}
+    anchor = i = 0
+    n = len(src)
+    while i < n - 12:
+        key = src[i:i + 4]
+        ref = table.get(key)
+        table[key] = i
+        if ref is None or i - ref > 0xFFFF:
+            i += 1
+            continue
+        m = 4
+        while i + m < n - 5 and src[ref + m] == src[i + m]:
+            m += 1
+        lit = i - anchor
+        out.append(min(lit, 15) << 4 | min(m - 4, 15))
+        if lit >= 15:
+            lz4_put_len(out, lit)
+        out += src[anchor:i]
+        out += struct.pack("<H", i - ref)
+        if m - 4 >= 15:
+            lz4_put_len(out, m - 4)
+        i += m
+        anchor = i
+    lit = n - anchor
+    out.append(min(lit, 15) << 4)
+    if lit >= 15:
+        lz4_put_len(out, lit)
+    out += src[anchor:]
+    return bytes(out)
+
+
+def lz4_decode(src):
+    out = bytearray()
+    i = 0
+
+    def get_len(n):
+        nonlocal i
+        if n == 15:
+            while True:
+                b = src[i]
+                i += 1
+                n += b
+                if b != 255:
+                    break
+        return n
+
+    while i < len(src):
+        token = src[i]
+        i += 1
+        n = get_len(token >> 4)
+        out += src[i:i + n]
+        i += n
+        if i >= len(src):
+            break
+        off = src[i] | src[i + 1] << 8
+        i += 2
+        n = get_len(token & 15) + 4
+        for _ in range(n):
+            out.append(out[-off])
+    return bytes(out)
+
+
+def encode_rect(seq, x, y, w, h, px):
+    raw = struct.pack("<%dH" % len(px), *px)
+    best = (RFB_RECT_RAW, raw)
+    for type, data in ((RFB_RECT_RLE, rle_encode(px)),
+                       (RFB_RECT_LZ4, lz4_encode(raw))):
+        if len(data) < len(best[1]):
+            best = (type, data)
+    type, data = best
+    return HDR.pack(RFB_MAGIC, type, seq & 0xFF, x, y, w, h, len(data)) + data
+
+
+def encode_frame(seq, width, height, px):
+    """Split the frame into full width bands that fit RFB_BUF_PX."""
+    band = max(1, RFB_BUF_PX // width)
+    out = bytearray()
+    for y in range(0, height, band):
+        h = min(band, height - y)
+        out += encode_rect(seq, 0, y, width, h, px[y * width:(y + h) * width])
+    out += HDR.pack(RFB_MAGIC, RFB_SYNC, seq & 0xFF, 0, 0, 0, 0, 0)
+    return bytes(out)
+
+
+def decode_stream(data, width, height):
+    """Reference sink, returns the frames seen at each sync."""
+    fb = [0] * (width * height)
+    frames = []
+    i = 0
+    while i + HDR.size <= len(data):
+        magic, type, seq, x, y, w, h, n = HDR.unpack_from(data, i)
+        assert magic == RFB_MAGIC, "lost sync at %d" % i
+        payload = data[i + HDR.size:i + HDR.size + n]
+        i += HDR.size + n
+        if type == RFB_SYNC:
+            frames.append(list(fb))
+            continue
+        assert w * h <= RFB_BUF_PX and n <= RFB_RX_SIZE
+        if type == RFB_RECT_RAW:
+            px = list(struct.unpack("<%dH" % (n // 2), payload))
+        elif type == RFB_RECT_RLE:
+            px = rle_decode(payload)
+        else:
+            raw = lz4_decode(payload)
+            px = list(struct.unpack("<%dH" % (len(raw) // 2), raw))
+        assert len(px) == w * h, "bad rect at %d" % i
+        for r in range(h):
+            fb[(y + r) * width + x:(y + r) * width + x + w] = px[r * w:(r + 1) * w]
+    return frames
+
+
+def rgb565(r, g, b):
+    r, g, b = r & 0xFF, g & 0xFF, b & 0xFF
+    return (r & 0xF8) << 8 | (g & 0xFC) << 3 | b >> 3
+
+
+def load_ppm(path, width, height):
+    with open(path, "rb") as f:
+        data = f.read()
+    fields = data.split(maxsplit=4)
+    assert fields[0] == b"P6", "only binary PPM is supported"
+    w, h = int(fields[1]), int(fields[2])
+    rgb = fields[4]
+    px = [0] * (width * height)
+    for y in range(min(h, height)):
+        for x in range(min(w, width)):
+            p = (y * w + x) * 3
+            px[y * width + x] = rgb565(rgb[p], rgb[p + 1], rgb[p + 2])
+    return px
+
+
+def pattern(n, width, height):
+    """Colour bars with a moving box, flat areas and edges for the codecs."""
+    bars = [rgb565(255, 255, 255), rgb565(255, 255, 0), rgb565(0, 255, 255),
+            rgb565(0, 255, 0), rgb565(255, 0, 255), rgb565(255, 0, 0),
+            rgb565(0, 0, 255), rgb565(0, 0, 0)]
+    px = [bars[x * len(bars) // width] for x in range(width)] * height
+    bx = n * 4 % (width - 64)
+    by = n * 3 % (height - 64)
+    for y in range(by, by + 64):
+        for x in range(bx, bx + 64):
+            px[y * width + x] = rgb565(x * 4, y * 4, n * 8)
+    return px
+
+
+def main():
+    ap = argparse.ArgumentParser(description="drive the panel over USB")
+    ap.add_argument("port", nargs="?")
+    ap.add_argument("image", nargs="?", help="binary PPM")
+    ap.add_argument("--pattern", action="store_true")
+    ap.add_argument("-n", "--frames", type=int, default=1)
+    ap.add_argument("--width", type=int, default=480)
+    ap.add_argument("--height", type=int, default=320)
+    ap.add_argument("--dump", help="write the stream to a file instead")
+    ap.add_argument("--check", action="store_true",
+                    help="decode the stream back instead of sending it")
+    ap.add_argument("--decoder",
+                    help="with --check, also run this build of rfb_check.c")
+    args = ap.parse_args()
+
+    if args.pattern:
+        frames = (pattern(i, args.width, args.height)
+                  for i in range(args.frames))
+    elif args.image:
+        frames = [load_ppm(args.image, args.width, args.height)] * args.frames
+    else:
+        ap.error("an image or --pattern is needed")
+
+    if args.check:
+        stream = bytearray()
+        expect = []
+        for seq, px in enumerate(frames):
+            data = encode_frame(seq, args.width, args.height, px)
+            got = decode_stream(data, args.width, args.height)
+            assert got == [px], "frame %d mismatch" % seq
+            stream += data
+            expect.append(px)
+        if args.decoder:
+            out = subprocess.run([args.decoder, "-w", str(args.width),
+                                  "-h", str(args.height)], input=bytes(stream),
+                                 stdout=subprocess.PIPE, check=True).stdout
+            size = args.width * args.height
+            got = struct.unpack("<%dH" % (len(out) // 2), out)
+            assert len(got) == size * len(expect), "firmware frame count"
+            for seq, px in enumerate(expect):
+                assert list(got[seq * size:(seq + 1) * size]) == px, \
+                    "firmware frame %d mismatch" % seq
+        print("ok")
+        return
+
+    if args.dump:
+        with open(args.dump, "wb") as f:
+            for seq, px in enumerate(frames):
+                f.write(encode_frame(seq, args.width, args.height, px))
+        return
+
+    if not args.port:
+        ap.error("a serial port is needed")
+
+    import serial
+    port = serial.Serial(args.port, 115200, timeout=5)
+    start = time.monotonic()
+    total = 0
+    for seq, px in enumerate(frames):
+        data = encode_frame(seq, args.width, args.height, px)
+        port.write(data)
+        total += len(data)
+
+        reply = port.read_until(RFB_MAGIC)
+        reply = port.read(HDR.size - 2)
+        if len(reply) != HDR.size - 2:
+            sys.exit("no sync reply for frame %d" % seq)
+        dropped = HDR.unpack(RFB_MAGIC + reply)[7]
+        if dropped:
+            print("sink dropped %d packets" % dropped)
+
+    t = time.monotonic() - start
+    print("%d frames, %.1f fps, %.1f KiB/frame" %
+          (seq + 1, (seq + 1) / t, total / (seq + 1) / 1024))
+    port.close()
+
+
+if __name__ == "__main__":
+    main()
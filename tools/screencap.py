@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+# Copyright (c) 2026 embeddedboys developers
+# SPDX-License-Identifier: MIT
+#
+# Host side of screencap.c, see include/screencap.h for the packet format.
+#
+#   screencap.py /dev/ttyACM0 shot.ppm          one screenshot
+#   screencap.py /dev/ttyACM0 -s frames/        stream, one PPM per frame
+#
+# Anything that is not a packet is printed as stdio text.
+
+import argparse
+import os
+import struct
+import sys
+
+import serial
+
+SCAP_MAGIC = b"\xa5\x5c"
+SCAP_FRAME_BEGIN = 1
+SCAP_TILE_DATA = 2
+SCAP_FRAME_END = 3
+
+
+class Frame:
+    def __init__(self):
+        self.width = 0
+        self.height = 0
+        self.px = bytearray()
+
+    def resize(self, width, height):
+        if (width, height) != (self.width, self.height):
+            self.width, self.height = width, height
+            self.px = bytearray(width * height * 3)
+
+    def put_tile(self, payload):
+        x, y, w, h, off = struct.unpack_from("<HHBBH", payload)
+        for i in range(8, len(payload) - 2, 3):
+            run, lo, hi = payload[i], payload[i + 1], payload[i + 2]
+            c = lo | hi << 8
+            rgb = bytes(((c >> 8) & 0xF8, (c >> 3) & 0xFC, (c << 3) & 0xF8))
+            for _ in range(run + 1):
+                px, py = x + off % w, y + off // w
+                if px < self.width and py < self.height:
+                    p = (py * self.width + px) * 3
+                    self.px[p:p + 3] = rgb
+                off += 1
+
+    def save(self, path):
+        with open(path, "wb") as f:
+            f.write(b"P6\n%d %d\n255\n" % (self.width, self.height))
+            f.write(self.px)
+
+
+def packets(port):
+    """Yield (type, payload), print the text in between."""
+    buf = bytearray()
+    while True:
+        buf += port.read(max(1, port.in_waiting))
+        while True:
+            i = buf.find(SCAP_MAGIC)
+            if i < 0:
+                # keep a trailing magic byte, it may be split
+                n = len(buf) - 1 if buf.endswith(SCAP_MAGIC[:1]) else len(buf)
+                sys.stdout.write(buf[:n].decode(errors="replace"))
+                del buf[:n]
+                break
+            sys.stdout.write(buf[:i].decode(errors="replace"))
+            del buf[:i]
+            if len(buf) < 4 or len(buf) < 4 + buf[3]:
+                break
+            yield buf[2], bytes(buf[4:4 + buf[3]])
+            del buf[:4 + buf[3]]
+
+
+def main():
+    ap = argparse.ArgumentParser(description="screenshot/stream over USB CDC")
+    ap.add_argument("port")
+    ap.add_argument("out", help="PPM file, or a directory with -s")
+    ap.add_argument("-s", "--stream", action="store_true")
+    args = ap.parse_args()
+
+    port = serial.Serial(args.port, 115200, timeout=0.1)
+    port.write(b"S" if args.stream else b"s")
+    if args.stream:
+        os.makedirs(args.out, exist_ok=True)
+
+    frame = Frame()
+    try:
+        for type, payload in packets(port):
+            if type == SCAP_FRAME_BEGIN:
+                num, w, h, delta = struct.unpack("<HHHB", payload)
+                frame.resize(w, h)
+            elif type == SCAP_TILE_DATA:
+                frame.put_tile(payload)
+            elif type == SCAP_FRAME_END:
+                if not args.stream:
+                    frame.save(args.out)
+                    break
+                frame.save(os.path.join(args.out, "%05d.ppm" % num))
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if args.stream:
+            port.write(b"S")
+        port.close()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,326 @@
+// Copyright (c) 2026 embeddedboys developers
+// SPDX-License-Identifier: MIT
+//
+// Host replay of touch_filter.c against recorded or synthetic traces.
+//
+//   cc -O2 -Iinclude -o touch_replay tools/touch_replay.c -lm
+//
+//   touch_replay trace.log          stdio log of a TOUCH_FILTER_TRACE=1 build
+//   touch_replay -s                 synthetic swipes, noise over a known path
+//   touch_replay -c 1 -b 0.01 -d 1 -p 12 -m 24 ...   filter parameters
+//   touch_replay -l 16 ...          latency to hide, ms
+//   touch_replay -o out.csv ...     t,in_x,in_y,ref_x,ref_y,out_x,out_y
+//
+// The reference is the true path for -s and the input itself otherwise.
+// A point reaches the screen a read period and a frame after the finger
+// was there, so the output is compared with where the reference is that
+// latency later. Jitter is the RMS frame to frame movement while the
+// reference rests, lag is how far the point trails the reference along
+// the motion, in ms, negative when it runs ahead. The unfiltered input is
+// measured the same way as the baseline the filter has to beat.
+
+#define TOUCH_FILTER_ENABLED 1
+#define TOUCH_FILTER_TRACE   0
+#define TOUCH_PREDICT_MS     12
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+
+#include "../touch_filter.c"
+
+#define MAX_SAMPLES (1 << 20)
+#define REST_SPEED  20.0 /* px/s */
+#define MOVE_SPEED  200.0
+#define LATENCY_MS  16.0 /* about half a read period and a 60 Hz frame */
+
+struct sample {
+	uint32_t t_us;
+	int16_t x, y; /* -1, -1: released */
+	double rx, ry; /* reference */
+	int16_t ox, oy;
+};
+
+static struct sample *samples;
+static int nr_samples;
+
+static void add_sample(uint32_t t_us, int x, int y, double rx, double ry)
+{
+	struct sample *s;
+
+	if (nr_samples == MAX_SAMPLES)
+		return;
+
+	s = &samples[nr_samples++];
+	s->t_us = t_us;
+	s->x = x;
+	s->y = y;
+	s->rx = rx;
+	s->ry = ry;
+}
+
+static int load_trace(const char *path)
+{
+	FILE *f = fopen(path, "r");
+	char line[256], *p;
+	unsigned long t;
+	int x, y;
+
+	if (!f) {
+		perror(path);
+		return -1;
+	}
+
+	/* anything else the firmware printed is skipped */
+	while (fgets(line, sizeof(line), f)) {
+		p = strstr(line, "tt ");
+		if (p && sscanf(p, "tt %lu %d %d", &t, &x, &y) == 3)
+			add_sample(t, x, y, x, y);
+	}
+
+	fclose(f);
+	return 0;
+}
+
+static double gauss(void)
+{
+	double u = (rand() + 1.0) / (RAND_MAX + 2.0);
+	double v = (rand() + 1.0) / (RAND_MAX + 2.0);
+
+	return sqrt(-2 * log(u)) * cos(2 * M_PI * v);
+}
+
+/* rests, eased swipes between random points and lifts, read every 11 ms */
+static void synth_trace(void)
+{
+	double x = 240, y = 160, x0, y0, x1, y1, d, k;
+	uint32_t t = 0, t0, dur;
+	int stroke, phase;
+
+	srand(1);
+	for (stroke = 0; stroke < 40; stroke++) {
+		for (phase = 0; phase < 3; phase++) {
+			x0 = x;
+			y0 = y;
+			x1 = 20 + rand() % 440;
+			y1 = 20 + rand() % 280;
+			d = hypot(x1 - x0, y1 - y0);
+			/* 600 to 2000 px/s on average, 300 ms at rest */
+			dur = phase == 1 ? 300000 :
+					   d / (600 + rand() % 1400) * 1e6;
+
+			for (t0 = t; t - t0 < dur; t += 11000 + rand() % 2000 - 1000) {
+				k = (double)(t - t0) / dur;
+				k = phase == 1 ? 0 : k * k * (3 - 2 * k);
+				x = x0 + (x1 - x0) * k;
+				y = y0 + (y1 - y0) * k;
+				add_sample(t, lround(x + 1.2 * gauss()),
+					   lround(y + 1.2 * gauss()), x, y);
+			}
+			if (phase == 1)
+				x = x0, y = y0;
+			else
+				x = x1, y = y1;
+		}
+		add_sample(t, -1, -1, 0, 0);
+		t += 200000;
+	}
+}
+
+static int released(const struct sample *s)
+{
+	return s->x < 0 && s->y < 0;
+}
+
+struct stats {
+	double jitter;
+	int rest;
+	double lag, err;
+	int move;
+};
+
+/* the reference `lat_us` after sample i, false past the end of the stroke */
+static int ref_later(int i, uint32_t lat_us, double *rx, double *ry)
+{
+	uint32_t t = samples[i].t_us + lat_us;
+	const struct sample *a, *b;
+	double k;
+	int j;
+
+	for (j = i + 1; j < nr_samples && !released(&samples[j]); j++) {
+		if (samples[j].t_us < t)
+			continue;
+
+		a = &samples[j - 1];
+		b = &samples[j];
+		k = b->t_us > a->t_us ?
+			    (double)(t - a->t_us) / (b->t_us - a->t_us) :
+			    1;
+		*rx = a->rx + (b->rx - a->rx) * k;
+		*ry = a->ry + (b->ry - a->ry) * k;
+		return 1;
+	}
+
+	return 0;
+}
+
+/* of the filter output, or of the input with `raw` */
+static void measure(struct stats *st, double latency_ms, int raw)
+{
+	const struct sample *a, *b, *c;
+	double vx, vy, v, dt, ex, ey, rx, ry, ax, ay, bx, by;
+	int i;
+
+	memset(st, 0, sizeof(*st));
+
+	for (i = 1; i < nr_samples - 1; i++) {
+		a = &samples[i - 1];
+		b = &samples[i];
+		c = &samples[i + 1];
+		if (released(a) || released(b) || released(c))
+			continue;
+
+		ax = raw ? a->x : a->ox;
+		ay = raw ? a->y : a->oy;
+		bx = raw ? b->x : b->ox;
+		by = raw ? b->y : b->oy;
+
+		dt = (c->t_us - a->t_us) * 1e-6;
+		vx = (c->rx - a->rx) / dt;
+		vy = (c->ry - a->ry) / dt;
+		v = hypot(vx, vy);
+
+		if (v < REST_SPEED) {
+			st->jitter += pow(bx - ax, 2) + pow(by - ay, 2);
+			st->rest++;
+		} else if (v > MOVE_SPEED &&
+			   ref_later(i, latency_ms * 1e3, &rx, &ry)) {
+			ex = rx - bx;
+			ey = ry - by;
+			st->lag += (ex * vx + ey * vy) / (v * v) * 1e3;
+			st->err += ex * ex + ey * ey;
+			st->move++;
+		}
+	}
+
+	if (st->rest)
+		st->jitter = sqrt(st->jitter / st->rest);
+	if (st->move) {
+		st->lag /= st->move;
+		st->err = sqrt(st->err / st->move);
+	}
+}
+
+static void usage(const char *prog)
+{
+	fprintf(stderr,
+		"usage: %s [-c min_cutoff] [-b beta] [-d d_cutoff] "
+		"[-p predict_ms] [-m predict_max] [-l latency_ms] "
+		"[-o out.csv] (-s | trace)\n",
+		prog);
+	exit(1);
+}
+
+int main(int argc, char **argv)
+{
+	struct touch_filter_params p = TOUCH_FILTER_DEFAULTS;
+	double latency_ms = LATENCY_MS;
+	const char *csv = NULL;
+	struct stats in, out;
+	int synth = 0, opt, i;
+	FILE *f;
+
+	while ((opt = getopt(argc, argv, "c:b:d:p:m:l:o:s")) != -1) {
+		switch (opt) {
+		case 'c':
+			p.min_cutoff = atof(optarg);
+			break;
+		case 'b':
+			p.beta = atof(optarg);
+			break;
+		case 'd':
+			p.d_cutoff = atof(optarg);
+			break;
+		case 'p':
+			p.predict_ms = atof(optarg);
+			break;
+		case 'm':
+			p.predict_max = atof(optarg);
+			break;
+		case 'l':
+			latency_ms = atof(optarg);
+			break;
+		case 'o':
+			csv = optarg;
+			break;
+		case 's':
+			synth = 1;
+			break;
+		default:
+			usage(argv[0]);
+		}
+	}
+
+	samples = calloc(MAX_SAMPLES, sizeof(*samples));
+	if (!samples)
+		return 1;
+
+	if (synth)
+		synth_trace();
+	else if (optind < argc)
+		load_trace(argv[optind]);
+	else
+		usage(argv[0]);
+
+	if (!nr_samples) {
+		fprintf(stderr, "no samples\n");
+		return 1;
+	}
+
+	touch_filter_set_params(&p);
+	for (i = 0; i < nr_samples; i++) {
+		struct sample *s = &samples[i];
+
+		if (released(s)) {
+			touch_filter_reset(s->t_us);
+			continue;
+		}
+
+		s->ox = s->x;
+		s->oy = s->y;
+		touch_filter_update(&s->ox, &s->oy, s->t_us);
+	}
+
+	if (csv) {
+		f = fopen(csv, "w");
+		if (!f) {
+			perror(csv);
+			return 1;
+		}
+		for (i = 0; i < nr_samples; i++) {
+			const struct sample *s = &samples[i];
+
+			if (!released(s))
+				fprintf(f, "%u,%d,%d,%.1f,%.1f,%d,%d\n", s->t_us,
+					s->x, s->y, s->rx, s->ry, s->ox, s->oy);
+		}
+		fclose(f);
+	}
+
+	measure(&in, latency_ms, 1);
+	measure(&out, latency_ms, 0);
+	printf("params : min_cutoff %.3g Hz, beta %.3g, d_cutoff %.3g Hz, "
+	       "predict %.3g ms / %.3g px\n",
+	       p.min_cutoff, p.beta, p.d_cutoff, p.predict_ms, p.predict_max);
+	printf("samples: %d, %d at rest, %d moving, %.3g ms latency\n",
+	       nr_samples, out.rest, out.move, latency_ms);
+	printf("          unfiltered  filtered\n");
+	printf("jitter : %8.2f px %8.2f px\n", in.jitter, out.jitter);
+	printf("lag    : %8.1f ms %8.1f ms\n", in.lag, out.lag);
+	printf("error  : %8.2f px %8.2f px rms while moving\n", in.err,
+	       out.err);
+
+	return 0;
+}
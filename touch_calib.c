@@ -0,0 +1,371 @@
+// Copyright (c) 2026 embeddedboys developers
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#define pr_fmt(fmt) "touch_calib: " fmt
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+#include "hardware/flash.h"
+
+#include "lvgl/lvgl.h"
+
+#include "ili9488.h"
+#include "ft6236.h"
+#include "touch_calib.h"
+#include "autotune.h"
+
+#if TOUCH_CALIB_POINTS
+
+#if TOUCH_CALIB_POINTS != 3 && TOUCH_CALIB_POINTS != 5
+#error "TOUCH_CALIB_POINTS must be 3 or 5"
+#endif
+
+#define pr_debug printf
+
+#define CALIB_MAGIC 0x54434c31 /* TCL1 */
+
+/* the sector below the clock profile of autotune.c */
+#define CALIB_FLASH_OFFS (PICO_FLASH_SIZE_BYTES - 2 * FLASH_SECTOR_SIZE)
+
+#define CALIB_TICK_MS  20
+#define CALIB_SAMPLES  8 /* at least, averaged while the cross is held */
+#define CALIB_MAX_ERR  6 /* px, worst residual of a 5 point fit */
+#define CALIB_MAX_GAIN 2.0 /* keeps ft6236_read_xy() sums in 32 bits */
+#define CALIB_CROSS    21
+
+struct calib_record {
+	uint32_t magic;
+	struct touch_matrix m;
+	uint32_t sum;
+};
+
+/* crosshair positions in 1/1000 of the screen */
+static const uint16_t calib_targets[][2] = {
+#if TOUCH_CALIB_POINTS == 3
+	{ 125, 125 },
+	{ 875, 500 },
+	{ 500, 875 },
+#else
+	{ 125, 125 },
+	{ 875, 125 },
+	{ 875, 875 },
+	{ 125, 875 },
+	{ 500, 500 },
+#endif
+};
+
+struct touch_calib {
+	lv_obj_t *scr;
+	lv_obj_t *prev;
+	lv_obj_t *cross;
+	lv_obj_t *label;
+	lv_timer_t *timer;
+	touch_calib_done_t done;
+
+	int point;
+	uint32_t sum_x;
+	uint32_t sum_y;
+	uint32_t samples;
+
+	double ref[TOUCH_CALIB_POINTS][2]; /* native panel coordinates */
+	double raw[TOUCH_CALIB_POINTS][2];
+} g_calib;
+
+static uint32_t calib_sum(const uint32_t *p, size_t words)
+{
+	uint32_t sum = 0x811c9dc5;
+
+	while (words--)
+		sum = (sum ^ *p++) * 0x01000193;
+
+	return sum;
+}
+
+static bool calib_record_valid(const struct calib_record *rec)
+{
+	return rec->magic == CALIB_MAGIC &&
+	       rec->sum == calib_sum((const uint32_t *)&rec->m,
+				     sizeof(rec->m) / 4);
+}
+
+static void calib_store_cb(void *param)
+{
+	flash_range_erase(CALIB_FLASH_OFFS, FLASH_SECTOR_SIZE);
+	if (param)
+		flash_range_program(CALIB_FLASH_OFFS, param, FLASH_PAGE_SIZE);
+}
+
+static int calib_store(const struct touch_matrix *m)
+{
+	static uint8_t page[FLASH_PAGE_SIZE];
+	struct calib_record *rec = (struct calib_record *)page;
+	int ret;
+
+	memset(page, 0xff, sizeof(page));
+	rec->magic = CALIB_MAGIC;
+	rec->m = *m;
+	rec->sum = calib_sum((const uint32_t *)&rec->m, sizeof(rec->m) / 4);
+
+	ret = flash_safe_execute(calib_store_cb, page, UINT32_MAX);
+	/* boot2 set the build time flash divider again */
+	clock_profile_flash_restore();
+	return ret;
+}
+
+/* solve the 3x3 normal equations s * p = v by Cramer's rule */
+static bool calib_solve3(const double s[3][3], const double v[3], double p[3])
+{
+	double det, d[3];
+	int i;
+
+	det = s[0][0] * (s[1][1] * s[2][2] - s[1][2] * s[2][1]) -
+	      s[0][1] * (s[1][0] * s[2][2] - s[1][2] * s[2][0]) +
+	      s[0][2] * (s[1][0] * s[2][1] - s[1][1] * s[2][0]);
+	if (fabs(det) < 1e-6)
+		return false;
+
+	for (i = 0; i < 3; i++) {
+		double m[3][3];
+
+		memcpy(m, s, sizeof(m));
+		m[0][i] = v[0];
+		m[1][i] = v[1];
+		m[2][i] = v[2];
+
+		d[i] = m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) -
+		       m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0]) +
+		       m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+	}
+
+	for (i = 0; i < 3; i++)
+		p[i] = d[i] / det;
+
+	return true;
+}
+
+/* least squares fit of raw -> native, exact for 3 points */
+static bool calib_fit(struct touch_calib *tc, struct touch_matrix *m)
+{
+	double s[3][3] = { 0 }, vx[3] = { 0 }, vy[3] = { 0 };
+	double px[3], py[3], err, max_err = 0;
+	int i;
+
+	for (i = 0; i < TOUCH_CALIB_POINTS; i++) {
+		double a[3] = { tc->raw[i][0], tc->raw[i][1], 1 };
+		int r, c;
+
+		for (r = 0; r < 3; r++) {
+			for (c = 0; c < 3; c++)
+				s[r][c] += a[r] * a[c];
+			vx[r] += a[r] * tc->ref[i][0];
+			vy[r] += a[r] * tc->ref[i][1];
+		}
+	}
+
+	if (!calib_solve3(s, vx, px) || !calib_solve3(s, vy, py))
+		return false;
+
+	for (i = 0; i < TOUCH_CALIB_POINTS; i++) {
+		err = hypot(px[0] * tc->raw[i][0] + px[1] * tc->raw[i][1] +
+				    px[2] - tc->ref[i][0],
+			    py[0] * tc->raw[i][0] + py[1] * tc->raw[i][1] +
+				    py[2] - tc->ref[i][1]);
+		if (err > max_err)
+			max_err = err;
+	}
+
+	pr_debug("fit error %d.%01d px\n", (int)max_err,
+		 (int)(max_err * 10) % 10);
+
+	if (max_err > CALIB_MAX_ERR || fabs(px[0]) > CALIB_MAX_GAIN ||
+	    fabs(px[1]) > CALIB_MAX_GAIN || fabs(py[0]) > CALIB_MAX_GAIN ||
+	    fabs(py[1]) > CALIB_MAX_GAIN)
+		return false;
+
+	m->xx = lround(px[0] * (1 << TOUCH_MATRIX_SHIFT));
+	m->xy = lround(px[1] * (1 << TOUCH_MATRIX_SHIFT));
+	m->x0 = lround(px[2] * (1 << TOUCH_MATRIX_SHIFT));
+	m->yx = lround(py[0] * (1 << TOUCH_MATRIX_SHIFT));
+	m->yy = lround(py[1] * (1 << TOUCH_MATRIX_SHIFT));
+	m->y0 = lround(py[2] * (1 << TOUCH_MATRIX_SHIFT));
+	return true;
+}
+
+/* screen position of the crosshair back to native panel coordinates */
+static void calib_to_native(int x, int y, double *nx, double *ny)
+{
+	const struct touch_matrix *r = ft6236_get_rotation_matrix();
+	const double one = 1 << TOUCH_MATRIX_SHIFT;
+	double det = ((double)r->xx * r->yy - (double)r->xy * r->yx) /
+		     (one * one);
+	double dx = x - r->x0 / one, dy = y - r->y0 / one;
+
+	*nx = (r->yy * dx - r->xy * dy) / one / det;
+	*ny = (r->xx * dy - r->yx * dx) / one / det;
+}
+
+static void calib_show_point(struct touch_calib *tc)
+{
+	int x = calib_targets[tc->point][0] * ili9488_get_xres() / 1000;
+	int y = calib_targets[tc->point][1] * ili9488_get_yres() / 1000;
+
+	calib_to_native(x, y, &tc->ref[tc->point][0], &tc->ref[tc->point][1]);
+
+	lv_obj_set_pos(tc->cross, x - CALIB_CROSS / 2, y - CALIB_CROSS / 2);
+	lv_label_set_text_fmt(tc->label, "Touch the cross  %d/%d",
+			      tc->point + 1, TOUCH_CALIB_POINTS);
+
+	tc->sum_x = tc->sum_y = tc->samples = 0;
+}
+
+static void calib_finish(struct touch_calib *tc, bool ok)
+{
+	lv_scr_load(tc->prev);
+	lv_obj_del(tc->scr);
+	lv_timer_del(tc->timer);
+	tc->scr = NULL;
+
+	if (tc->done)
+		tc->done(ok);
+}
+
+static void calib_timer_cb(lv_timer_t *timer)
+{
+	struct touch_calib *tc = timer->user_data;
+	struct touch_matrix m;
+	uint16_t x, y;
+
+	if (ft6236_is_pressed()) {
+		ft6236_read_raw(&x, &y);
+		tc->sum_x += x;
+		tc->sum_y += y;
+		tc->samples++;
+		return;
+	}
+
+	/* a bounce, not a deliberate touch */
+	if (tc->samples < CALIB_SAMPLES) {
+		tc->sum_x = tc->sum_y = tc->samples = 0;
+		return;
+	}
+
+	tc->raw[tc->point][0] = (double)tc->sum_x / tc->samples;
+	tc->raw[tc->point][1] = (double)tc->sum_y / tc->samples;
+
+	if (++tc->point < TOUCH_CALIB_POINTS) {
+		calib_show_point(tc);
+		return;
+	}
+
+	if (!calib_fit(tc, &m)) {
+		pr_debug("points are inconsistent, again\n");
+		tc->point = 0;
+		calib_show_point(tc);
+		return;
+	}
+
+	pr_debug("x = %ld * rx + %ld * ry + %ld\n", m.xx, m.xy, m.x0);
+	pr_debug("y = %ld * rx + %ld * ry + %ld\n", m.yx, m.yy, m.y0);
+
+	ft6236_set_calibration(&m);
+	calib_finish(tc, calib_store(&m) == PICO_OK);
+}
+
+static lv_obj_t *calib_bar(lv_obj_t *parent, lv_coord_t w, lv_coord_t h)
+{
+	lv_obj_t *obj = lv_obj_create(parent);
+
+	lv_obj_remove_style_all(obj);
+	lv_obj_set_size(obj, w, h);
+	lv_obj_set_style_bg_color(obj, lv_color_white(), 0);
+	lv_obj_set_style_bg_opa(obj, LV_OPA_COVER, 0);
+	lv_obj_center(obj);
+	return obj;
+}
+
+/*
+ * Raw samples are read by a timer of its own, the LVGL input device keeps
+ * running on the old matrix and only sees a screen without widgets.
+ */
+void touch_calib_start(touch_calib_done_t done)
+{
+	struct touch_calib *tc = &g_calib;
+
+	if (tc->scr)
+		return;
+
+	tc->done = done;
+	tc->prev = lv_scr_act();
+
+	tc->scr = lv_obj_create(NULL);
+	lv_obj_clear_flag(tc->scr, LV_OBJ_FLAG_SCROLLABLE);
+	lv_obj_set_style_bg_color(tc->scr, lv_color_black(), 0);
+
+	tc->label = lv_label_create(tc->scr);
+	lv_obj_set_style_text_color(tc->label, lv_color_white(), 0);
+	lv_obj_center(tc->label);
+
+	tc->cross = lv_obj_create(tc->scr);
+	lv_obj_remove_style_all(tc->cross);
+	lv_obj_set_size(tc->cross, CALIB_CROSS, CALIB_CROSS);
+	calib_bar(tc->cross, CALIB_CROSS, 1);
+	calib_bar(tc->cross, 1, CALIB_CROSS);
+
+	tc->point = 0;
+	calib_show_point(tc);
+
+	lv_scr_load(tc->scr);
+	tc->timer = lv_timer_create(calib_timer_cb, CALIB_TICK_MS, tc);
+}
+
+/* drop the stored matrix, touch goes back to the raw coordinates */
+void touch_calib_reset(void)
+{
+	ft6236_set_calibration(NULL);
+	flash_safe_execute(calib_store_cb, NULL, UINT32_MAX);
+	clock_profile_flash_restore();
+}
+
+/* apply the stored matrix, true if there is one */
+bool touch_calib_init(void)
+{
+	const struct calib_record *rec =
+		(const struct calib_record *)(XIP_BASE + CALIB_FLASH_OFFS);
+
+	if (calib_record_valid(rec)) {
+		ft6236_set_calibration(&rec->m);
+		pr_debug("using the stored calibration\n");
+		return true;
+	}
+
+	pr_debug("not calibrated\n");
+	if (TOUCH_CALIB_AT_BOOT)
+		touch_calib_start(NULL);
+
+	return false;
+}
+
+#endif
@@ -0,0 +1,126 @@
+// Copyright (c) 2026 embeddedboys developers
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "touch_filter.h"
+
+#if TOUCH_FILTER_ENABLED
+
+#define TWO_PI 6.2831853f
+
+/* samples closer than this are the controller repeating itself */
+#define TF_MIN_DT_US 1000
+/* a gap this long is a new stroke even without a release */
+#define TF_MAX_DT_US 100000
+
+struct tf_axis {
+	float x; /* filtered position */
+	float dx; /* filtered speed, px/s */
+};
+
+struct touch_filter {
+	struct touch_filter_params p;
+	struct tf_axis ax[2];
+	uint32_t last_us;
+	bool active;
+};
+
+static struct touch_filter g_tf = {
+	.p = TOUCH_FILTER_DEFAULTS,
+};
+
+static inline float tf_alpha(float cutoff, float dt)
+{
+	float tau = 1.0f / (TWO_PI * cutoff);
+
+	return 1.0f / (1.0f + tau / dt);
+}
+
+static inline float tf_axis_update(struct tf_axis *a,
+				   const struct touch_filter_params *p,
+				   float x, float dt)
+{
+	float dx = (x - a->x) / dt;
+	float cutoff, ofs;
+
+	a->dx += tf_alpha(p->d_cutoff, dt) * (dx - a->dx);
+	cutoff = p->min_cutoff + p->beta * fabsf(a->dx);
+	a->x += tf_alpha(cutoff, dt) * (x - a->x);
+
+	ofs = a->dx * p->predict_ms * 0.001f;
+	ofs = fminf(fmaxf(ofs, -p->predict_max), p->predict_max);
+
+	return a->x + ofs;
+}
+
+/* replaces *x, *y with the filtered and extrapolated point */
+void touch_filter_update(int16_t *x, int16_t *y, uint32_t t_us)
+{
+	struct touch_filter *tf = &g_tf;
+	uint32_t dt_us = t_us - tf->last_us;
+
+#if TOUCH_FILTER_TRACE
+	printf("tt %lu %d %d\n", (unsigned long)t_us, *x, *y);
+#endif
+
+	if (!tf->active || dt_us > TF_MAX_DT_US) {
+		tf->ax[0] = (struct tf_axis){ *x, 0 };
+		tf->ax[1] = (struct tf_axis){ *y, 0 };
+		tf->last_us = t_us;
+		tf->active = true;
+		return;
+	}
+
+	if (dt_us < TF_MIN_DT_US)
+		dt_us = TF_MIN_DT_US;
+	tf->last_us = t_us;
+
+	*x = lroundf(tf_axis_update(&tf->ax[0], &tf->p, *x, dt_us * 1e-6f));
+	*y = lroundf(tf_axis_update(&tf->ax[1], &tf->p, *y, dt_us * 1e-6f));
+}
+
+/* the finger is up, the next sample starts a new stroke */
+void touch_filter_reset(uint32_t t_us)
+{
+#if TOUCH_FILTER_TRACE
+	if (g_tf.active)
+		printf("tt %lu -1 -1\n", (unsigned long)t_us);
+#else
+	(void)t_us;
+#endif
+	g_tf.active = false;
+}
+
+void touch_filter_set_params(const struct touch_filter_params *p)
+{
+	g_tf.p = *p;
+}
+
+void touch_filter_get_params(struct touch_filter_params *p)
+{
+	*p = g_tf.p;
+}
+
+#endif
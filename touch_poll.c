@@ -0,0 +1,131 @@
+// Copyright (c) 2026 embeddedboys developers
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include <stdio.h>
+#include <string.h>
+
+#include "pico/time.h"
+
+#include "lvgl/lvgl.h"
+
+#include "ft6236.h"
+#include "touch_poll.h"
+
+#if TOUCH_POLL_ADAPTIVE
+
+#define pr_debug printf
+
+#define TOUCH_POLL_REPORT_PERIOD_MS 1000
+
+struct touch_poll_stats {
+	uint32_t polls;
+	uint32_t pressed;
+	uint32_t age_us; /* sample taken to LVGL read */
+	uint32_t age_max_us;
+};
+
+struct touch_poll {
+	lv_timer_t *timer;
+	uint32_t period_ms;
+	uint32_t last_press_us;
+	alarm_id_t alarm;
+
+	struct touch_poll_stats stats;
+} g_touch_poll;
+
+static int64_t touch_poll_alarm_cb(alarm_id_t id, void *user_data)
+{
+	g_touch_poll.alarm = 0;
+	ft6236_poll_start();
+	return 0;
+}
+
+/* called by the LVGL read with the sample it got */
+void touch_poll_update(bool pressed, uint32_t t_us)
+{
+	struct touch_poll *tp = &g_touch_poll;
+	uint32_t now = time_us_32();
+	uint32_t age = now - t_us;
+	uint32_t period = tp->period_ms;
+
+	tp->stats.polls++;
+	tp->stats.pressed += pressed;
+	tp->stats.age_us += age;
+	if (age > tp->stats.age_max_us)
+		tp->stats.age_max_us = age;
+
+	if (pressed) {
+		tp->last_press_us = now;
+		period = TOUCH_POLL_FAST_MS;
+	} else if (now - tp->last_press_us > TOUCH_POLL_HOLD_MS * 1000) {
+		period = LV_MIN(period * 2, TOUCH_POLL_SLOW_MS);
+	}
+
+	if (period != tp->period_ms) {
+		tp->period_ms = period;
+		lv_timer_set_period(tp->timer, period);
+	}
+
+	/* LVGL reads again in period ms, have the sample ready by then */
+	if (tp->alarm)
+		cancel_alarm(tp->alarm);
+	tp->alarm = add_alarm_in_us(period * 1000 - TOUCH_POLL_LEAD_US,
+				    touch_poll_alarm_cb, NULL, true);
+	if (tp->alarm < 0) {
+		tp->alarm = 0;
+		ft6236_poll_start();
+	}
+}
+
+#if PERF_STATS_ENABLED
+static void touch_poll_report_cb(lv_timer_t *timer)
+{
+	struct touch_poll *tp = &g_touch_poll;
+	struct touch_poll_stats s = tp->stats;
+
+	memset(&tp->stats, 0, sizeof(tp->stats));
+
+	pr_debug("touch: %u polls/s, %u pressed, period %u ms, sample age avg %u us, max %u us\n",
+		 s.polls * 1000 / TOUCH_POLL_REPORT_PERIOD_MS, s.pressed,
+		 tp->period_ms, s.polls ? s.age_us / s.polls : 0,
+		 s.age_max_us);
+}
+#endif
+
+void touch_poll_init(lv_indev_t *indev)
+{
+	struct touch_poll *tp = &g_touch_poll;
+
+	tp->timer = indev->driver->read_timer;
+	tp->period_ms = TOUCH_POLL_FAST_MS;
+	tp->last_press_us = time_us_32();
+	lv_timer_set_period(tp->timer, tp->period_ms);
+
+	ft6236_set_report_rate(1000 / TOUCH_POLL_FAST_MS);
+	ft6236_poll_start();
+
+#if PERF_STATS_ENABLED
+	lv_timer_create(touch_poll_report_cb, TOUCH_POLL_REPORT_PERIOD_MS, NULL);
+#endif
+}
+
+#endif